@@ -47,20 +47,53 @@ echo "Cross prefix: $CROSS_PREFIX"
 mkdir -p build
 mkdir -p dist/hera
 
+# Engine sources, shared by the plugin and the tests
+ENGINE_SRCS="
+    src/dsp/Engine/HeraEnvelope.cpp
+    src/dsp/Engine/HeraLFO.cpp
+    src/dsp/Engine/HeraLFOWithEnvelope.cpp
+    src/dsp/Engine/HeraTables.cpp
+    src/dsp/Engine/bbd_line.cpp
+    src/dsp/Engine/bbd_filter.cpp"
+
 # Compile DSP plugin
 echo "Compiling DSP plugin..."
 ${CROSS_PREFIX}g++ -g -O3 -shared -fPIC -std=c++14 \
     src/dsp/hera_plugin.cpp \
-    src/dsp/Engine/HeraEnvelope.cpp \
-    src/dsp/Engine/HeraLFO.cpp \
-    src/dsp/Engine/HeraLFOWithEnvelope.cpp \
-    src/dsp/Engine/HeraTables.cpp \
-    src/dsp/Engine/bbd_line.cpp \
-    src/dsp/Engine/bbd_filter.cpp \
+    $ENGINE_SRCS \
     -o build/dsp.so \
     -Isrc/dsp \
     -Isrc/dsp/Engine \
-    -lm
+    -lm -lpthread
+
+# Compile presets into a binary bank (runs on the build host)
+HOST_CXX="${HOST_CXX:-g++}"
+rm -f build/presets.bin
+if command -v "$HOST_CXX" >/dev/null 2>&1; then
+    echo "Compiling preset bank..."
+    "$HOST_CXX" -O2 -std=c++14 src/tools/presetc.cpp -Isrc/dsp -o build/presetc
+    build/presetc -o build/presets.bin src/presets/Preset*.xml
+else
+    echo "No host compiler ($HOST_CXX), skipping presets.bin; the plugin will read the XML presets"
+fi
+
+# Build and run the DSP tests on the build host; a failing test fails the build
+run_host_test() {
+    local name="$1"
+    shift
+    "$HOST_CXX" -O2 -std=c++14 "tests/$name.cpp" "$@" -Isrc/dsp -Isrc/dsp/Engine \
+        -o "build/$name" -lm -lpthread
+    "build/$name"
+}
+
+if command -v "$HOST_CXX" >/dev/null 2>&1; then
+    echo "Running tests..."
+    run_host_test test_fast_exp2
+    run_host_test test_control_rate $ENGINE_SRCS
+    run_host_test test_envelope_segments src/dsp/Engine/HeraEnvelope.cpp src/dsp/Engine/HeraTables.cpp
+else
+    echo "No host compiler ($HOST_CXX), skipping tests"
+fi
 
 # Copy files to dist (use cat to avoid ExtFS deallocation issues with Docker)
 echo "Packaging..."
@@ -69,6 +102,8 @@ cat src/module.json > dist/hera/module.json
 cat src/ui.js > dist/hera/ui.js
 cat build/dsp.so > dist/hera/dsp.so
 chmod +x dist/hera/dsp.so
+rm -f dist/hera/presets.bin
+[ -f build/presets.bin ] && cat build/presets.bin > dist/hera/presets.bin
 
 # Copy presets
 if [ -d "src/presets" ]; then
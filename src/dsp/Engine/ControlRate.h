@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Move Anything: control-rate evaluation of sub-audio modulation
+//
+// controlRateFillExp2 fills out[i] = scale * 2^octaves(i), evaluating
+// octaves(i) only at every interval-th sample and at the last sample. In
+// between it interpolates linearly in octaves: one exp2 per point and a
+// multiply per sample. Each call starts from an exact value at sample 0, so
+// no state carries over from one block to the next. An interval of 1
+// evaluates every sample.
+
+#pragma once
+#include "FastExp2.h"
+
+template <class OctavesAt>
+static inline void controlRateFillExp2(float *out, int count, int interval, float scale,
+                                       OctavesAt octaves)
+{
+    if (interval <= 1) {
+        for (int i = 0; i < count; ++i)
+            out[i] = octaves(i);
+        fastExp2Buffer(out, out, scale, count);
+        return;
+    }
+    if (count <= 0)
+        return;
+
+    int prev = 0;
+    float prevOctaves = octaves(0);
+    float prevValue = out[0] = scale * fastExp2(prevOctaves);
+    while (prev < count - 1) {
+        int next = prev + interval;
+        if (next > count - 1)
+            next = count - 1;
+        float nextOctaves = octaves(next);
+        float ratio = fastExp2((nextOctaves - prevOctaves) / float(next - prev));
+        float value = prevValue;
+        for (int i = prev + 1; i < next; ++i)
+            out[i] = value *= ratio;
+        prevValue = out[next] = scale * fastExp2(nextOctaves);
+        prev = next;
+        prevOctaves = nextOctaves;
+    }
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Move Anything: bounded-error exp2 for modulation paths
+//
+// 2^x = 2^floor(x) * 2^frac, with 2^floor(x) built in the exponent bits and
+// 2^frac from a degree-5 polynomial on [0, 1). Relative error is below
+// 3e-7 (about 2.5 ulp) for x in [-126, 127]; x is clamped to that range.
+// Used where the exponent is a modulation value (pitch, cutoff octaves),
+// not where std::exp2's last ulp or its handling of inf/NaN matters.
+
+#pragma once
+#include "SimdLanes.h"
+#include <string.h>
+
+namespace FastExp2Detail {
+static constexpr float kMin = -126.0f;
+static constexpr float kMax = 127.0f;
+static constexpr float c0 = 9.9999994e-1f;
+static constexpr float c1 = 6.9315308e-1f;
+static constexpr float c2 = 2.4015361e-1f;
+static constexpr float c3 = 5.5826318e-2f;
+static constexpr float c4 = 8.9893397e-3f;
+static constexpr float c5 = 1.8775767e-3f;
+} // namespace FastExp2Detail
+
+static inline float fastExp2(float x)
+{
+    using namespace FastExp2Detail;
+    x = (x < kMin) ? kMin : (x > kMax) ? kMax : x;
+    int xi = (int)x;
+    xi -= (float)xi > x;  // floor
+    float f = x - (float)xi;
+    float p = c0 + f * (c1 + f * (c2 + f * (c3 + f * (c4 + f * c5))));
+    int32_t bits = (xi + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+static inline SimdFloat fastExp2(SimdFloat x)
+{
+    using namespace FastExp2Detail;
+    x = simdMin(simdMax(x, simdSplat(kMin)), simdSplat(kMax));
+    SimdInt xi = simdToInt(x);
+    xi += (simdToFloat(xi) > x);  // floor: comparisons yield -1
+    SimdFloat f = x - simdToFloat(xi);
+    SimdFloat p = c0 + f * (c1 + f * (c2 + f * (c3 + f * (c4 + f * c5))));
+    SimdInt bits = (xi + 127) << 23;
+    return p * (SimdFloat)bits;
+}
+
+// out[i] = scale * 2^in[i]. in and out may be the same buffer.
+static inline void fastExp2Buffer(const float *in, float *out, float scale, int count)
+{
+    int i = 0;
+    for (; i + kSimdLanes <= count; i += kSimdLanes) {
+        SimdFloat x;
+        memcpy(&x, in + i, sizeof(x));
+        SimdFloat y = scale * fastExp2(x);
+        memcpy(out + i, &y, sizeof(y));
+    }
+    for (; i < count; ++i)
+        out[i] = scale * fastExp2(in[i]);
+}
@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Move Anything: voice-parallel port of HeraDCO.hxx
+//
+// The Faust DCO is transposed to structure-of-arrays form: each fRec* state
+// holds one voice per SIMD lane, and four voices advance per instruction.
+// Lanes that are not in the active mask compute but keep their old state.
+
+#pragma once
+#include "SimdLanes.h"
+#include <algorithm>
+#include <cmath>
+
+class HeraDCOx4 {
+public:
+    void init(int sample_rate)
+    {
+        fConst0 = float(sample_rate);
+        fConst1 = std::exp((0.0f - (100.0f / fConst0)));
+        fConst2 = (1.0f / fConst0);
+        fHslider0 = 0.5f;
+        fHslider2 = 0.0f;
+        fHslider3 = 0.0f;
+        fHslider4 = 0.0f;
+        fHslider1 = simdSplat(0.0f);
+        for (int l = 0; l < kSimdLanes; ++l)
+            clearLane(l);
+    }
+
+    void setSawLevel(float value) { fHslider0 = value; }
+    void setPulseLevel(float value) { fHslider2 = value; }
+    void setSubLevel(float value) { fHslider3 = value; }
+    void setNoiseLevel(float value) { fHslider4 = value; }
+    void setFrequency(int lane, float value) { fHslider1[lane] = value; }
+
+    void clearLane(int lane)
+    {
+        fRec0[lane] = fRec1[lane] = fRec2[lane] = fRec3[lane] = 0.0f;
+        fRec4[lane] = fRec5[lane] = fRec6[lane] = fRec7[lane] = 0.0f;
+        fRec8[lane] = fRec9[lane] = fRec10[lane] = 0.0f;
+        iRec12[lane] = 0;
+        for (int j = 0; j < 4; ++j)
+            fRec11[j][lane] = 0.0f;
+    }
+
+    // Equivalent of flushSmoothValues(HeraDCO&) for one lane
+    void flushSmoothValues(int lane)
+    {
+        static const float zero[1] = {};
+        const float *in[kSimdLanes] = { zero, zero, zero, zero };
+        float discard[kSimdLanes][1];
+        float *out[kSimdLanes] = { discard[0], discard[1], discard[2], discard[3] };
+        SimdMask mask = simdLaneMask(1u << lane);
+        process(zero, in, out, 1, mask, mask);
+    }
+
+    // detune: shared pitch factor, pwm/out: one buffer per lane.
+    void process(const float *detune, const float *const *pwm, float *const *out,
+                 int count, SimdMask active, SimdMask smoothDisabled)
+    {
+        SimdFloat fSlow0 = simdSelect(smoothDisabled, simdSplat(0.0f), simdSplat(fConst1));
+        SimdFloat fSlow1 = (1.0f - fSlow0);
+        SimdFloat fSlow2 = ((0.200000003f * fHslider0) * fSlow1);
+        SimdFloat fSlow3 = (fHslider1 * fSlow1);
+        SimdFloat fSlow4 = ((0.200000003f * fHslider2) * fSlow1);
+        SimdFloat fSlow5 = ((0.194999993f * fHslider3) * fSlow1);
+        SimdFloat fSlow6 = (std::max(9.99999997e-07f, (0.209999993f * fHslider4)) * fSlow1);
+        const float fConst0 = this->fConst0;
+        const float fConst1 = this->fConst1;
+        const float fConst2 = this->fConst2;
+
+        SimdFloat r0 = fRec0, r1 = fRec1, r2 = fRec2, r3 = fRec3;
+        SimdFloat r4 = fRec4, r5 = fRec5, r6 = fRec6, r7 = fRec7;
+        SimdFloat r8 = fRec8, r9 = fRec9, r10 = fRec10;
+        SimdUInt i12 = (SimdUInt)iRec12;
+        SimdFloat r11_1 = fRec11[1], r11_2 = fRec11[2], r11_3 = fRec11[3];
+
+        const SimdFloat zero = simdSplat(0.0f);
+        const SimdFloat one = simdSplat(1.0f);
+        const SimdFloat minusOne = simdSplat(-1.0f);
+
+        for (int i = 0; i < count; ++i) {
+            SimdFloat fRec0_0 = (fSlow2 + (fSlow0 * r0));
+            SimdFloat fRec2_0 = (fSlow3 + (fSlow0 * r2));
+            SimdFloat fTemp0 = (detune[i] * fRec2_0);
+            SimdFloat fTemp1 = (fConst2 * fTemp0);
+            SimdFloat fTemp2 = simdTrunc(r1);
+            SimdFloat fRec1_0 = ((r1 + fTemp1) - fTemp2);
+            SimdFloat fTemp3 = simdTrunc(fRec1_0);
+            SimdFloat fTemp4 = (fRec1_0 - fTemp3);
+            SimdFloat fTemp5 = (fRec1_0 + (-1.0f - fTemp3));
+            SimdFloat fTemp6 = simdSelect(fTemp4 < fTemp1,
+                ((fConst0 * ((fTemp4 * (2.0f - (fConst0 * (fTemp4 / fTemp0)))) / fTemp0)) + -1.0f),
+                simdSelect(((fRec1_0 + fTemp1) - fTemp3) > 1.0f,
+                    ((fConst0 * ((fTemp5 * ((fConst0 * (fTemp5 / fTemp0)) + 2.0f)) / fTemp0)) + 1.0f),
+                    zero));
+            SimdFloat fRec3_0 = (fSlow4 + (fSlow0 * r3));
+            SimdMask iTemp7 = (fRec1_0 >= 1.0f);
+            SimdFloat fTemp8 = SimdFloat{ pwm[0][i], pwm[1][i], pwm[2][i], pwm[3][i] };
+            SimdFloat fRec4_0 = simdSelect(iTemp7, (0.5f - (0.449999988f * fTemp8)), r4);
+            SimdMask iTemp9 = (fTemp4 > fRec4_0);
+            SimdFloat fTemp10 = (0.949999988f * fTemp8);
+            SimdFloat fRec5_0 = simdSelect(iTemp7, (0.449999988f * (2.0f - fTemp10)), r5);
+            SimdFloat fRec6_0 = simdSelect(iTemp7, minusOne, simdSelect(iTemp9, r6, (fConst1 * r6)));
+            SimdFloat fRec7_0 = simdSelect(iTemp7, (1.0f - fTemp10), simdSelect(iTemp9, (fConst1 * r7), r7));
+            SimdFloat fTemp11 = (fRec4_0 + fTemp3);
+            SimdFloat fTemp12 = (fRec1_0 - fTemp11);
+            SimdFloat fTemp13 = simdSelect(fTemp12 < 0.0f, (fRec1_0 + (1.0f - fTemp11)), fTemp12);
+            SimdFloat fTemp14 = (fTemp13 + -1.0f);
+            SimdFloat fRec8_0 = (fSlow5 + (fSlow0 * r8));
+            SimdFloat fRec9_0 = simdSelect(((r1 - fTemp2) < 0.5f) & (fTemp4 >= 0.5f),
+                simdSelect(r9 > 0.0f, minusOne, one), (fConst1 * r9));
+            SimdFloat fTemp15 = (fRec1_0 + (-0.5f - fTemp3));
+            SimdFloat fTemp16 = simdSelect(fTemp15 < 0.0f, (fRec1_0 + (0.5f - fTemp3)), fTemp15);
+            SimdFloat fTemp17 = (fTemp16 + -1.0f);
+            SimdFloat fRec10_0 = (fSlow6 + (fSlow0 * r10));
+            i12 = ((1103515245u * i12) + 12345u);
+            SimdFloat fRec11_0 = (((0.522189379f * r11_3) + ((4.65661287e-10f * simdToFloat((SimdInt)i12)) + (2.49495602f * r11_1))) - (2.0172658f * r11_2));
+            SimdFloat fBlep13 = simdSelect(fTemp13 < fTemp1,
+                ((fConst0 * ((fTemp13 * (2.0f - (fConst0 * (fTemp13 / fTemp0)))) / fTemp0)) + -1.0f),
+                simdSelect((fTemp1 + fTemp13) > 1.0f,
+                    ((fConst0 * ((fTemp14 * ((fConst0 * (fTemp14 / fTemp0)) + 2.0f)) / fTemp0)) + 1.0f),
+                    zero));
+            SimdFloat fBlep16 = simdSelect(fTemp16 < fTemp1,
+                ((fConst0 * ((fTemp16 * (2.0f - (fConst0 * (fTemp16 / fTemp0)))) / fTemp0)) + -1.0f),
+                simdSelect((fTemp1 + fTemp16) > 1.0f,
+                    ((fConst0 * ((fTemp17 * ((fConst0 * (fTemp17 / fTemp0)) + 2.0f)) / fTemp0)) + 1.0f),
+                    zero));
+            SimdFloat fSaw = (fRec0_0 * ((2.0f * fTemp4) + (-1.0f - fTemp6)));
+            SimdFloat fPulse = (fRec3_0 * (simdSelect(iTemp9, fRec7_0, fRec6_0) - (fRec5_0 * (fTemp6 - fBlep13))));
+            SimdFloat fSub = (fRec8_0 * (fRec9_0 - (fConst1 * (r9 * fBlep16))));
+            SimdFloat fNoise = (fRec10_0 * (((0.0499220341f * fRec11_0) + (0.0506126992f * r11_2)) - ((0.0959935337f * r11_1) + (0.00440878607f * r11_3))));
+            SimdFloat fNorm = ((0.300000012f * (simdMax((((fRec0_0 + fRec3_0) + fRec8_0) + fRec10_0), simdSplat(0.25999999f)) + -0.25999999f)) + 0.25999999f);
+            SimdFloat fOut = (((0.25999999f * ((fSaw + fPulse) + fSub)) + (3.25f * fNoise)) / fNorm);
+            out[0][i] = fOut[0];
+            out[1][i] = fOut[1];
+            out[2][i] = fOut[2];
+            out[3][i] = fOut[3];
+            r0 = fRec0_0;
+            r2 = fRec2_0;
+            r1 = fRec1_0;
+            r3 = fRec3_0;
+            r4 = fRec4_0;
+            r5 = fRec5_0;
+            r6 = fRec6_0;
+            r7 = fRec7_0;
+            r8 = fRec8_0;
+            r9 = fRec9_0;
+            r10 = fRec10_0;
+            r11_3 = r11_2;
+            r11_2 = r11_1;
+            r11_1 = fRec11_0;
+        }
+
+        fRec0 = simdSelect(active, r0, fRec0);
+        fRec1 = simdSelect(active, r1, fRec1);
+        fRec2 = simdSelect(active, r2, fRec2);
+        fRec3 = simdSelect(active, r3, fRec3);
+        fRec4 = simdSelect(active, r4, fRec4);
+        fRec5 = simdSelect(active, r5, fRec5);
+        fRec6 = simdSelect(active, r6, fRec6);
+        fRec7 = simdSelect(active, r7, fRec7);
+        fRec8 = simdSelect(active, r8, fRec8);
+        fRec9 = simdSelect(active, r9, fRec9);
+        fRec10 = simdSelect(active, r10, fRec10);
+        iRec12 = (SimdInt)((SimdUInt)active & i12) | (~active & iRec12);
+        fRec11[1] = simdSelect(active, r11_1, fRec11[1]);
+        fRec11[2] = simdSelect(active, r11_2, fRec11[2]);
+        fRec11[3] = simdSelect(active, r11_3, fRec11[3]);
+    }
+
+private:
+    float fConst0 = 44100.0f;
+    float fConst1 = 0.0f;
+    float fConst2 = 0.0f;
+    float fHslider0 = 0.5f;     /* saw level */
+    float fHslider2 = 0.0f;     /* pulse level */
+    float fHslider3 = 0.0f;     /* sub level */
+    float fHslider4 = 0.0f;     /* noise level */
+    SimdFloat fHslider1 = {};   /* frequency, per lane */
+    SimdFloat fRec0 = {};
+    SimdFloat fRec1 = {};
+    SimdFloat fRec2 = {};
+    SimdFloat fRec3 = {};
+    SimdFloat fRec4 = {};
+    SimdFloat fRec5 = {};
+    SimdFloat fRec6 = {};
+    SimdFloat fRec7 = {};
+    SimdFloat fRec8 = {};
+    SimdFloat fRec9 = {};
+    SimdFloat fRec10 = {};
+    SimdInt iRec12 = {};
+    SimdFloat fRec11[4] = {};
+};
+
+template <int NumVoices, int MaxBlockSize>
+class HeraDCOBank {
+public:
+    static constexpr int kNumGroups = (NumVoices + kSimdLanes - 1) / kSimdLanes;
+
+    void init(int sample_rate)
+    {
+        for (HeraDCOx4 &g : groups)
+            g.init(sample_rate);
+    }
+
+    void setSawLevel(float value) { for (HeraDCOx4 &g : groups) g.setSawLevel(value); }
+    void setPulseLevel(float value) { for (HeraDCOx4 &g : groups) g.setPulseLevel(value); }
+    void setSubLevel(float value) { for (HeraDCOx4 &g : groups) g.setSubLevel(value); }
+    void setNoiseLevel(float value) { for (HeraDCOx4 &g : groups) g.setNoiseLevel(value); }
+
+    void setFrequency(int voice, float value)
+    {
+        groups[voice / kSimdLanes].setFrequency(voice % kSimdLanes, value);
+    }
+
+    void clearVoice(int voice)
+    {
+        groups[voice / kSimdLanes].clearLane(voice % kSimdLanes);
+    }
+
+    void flushSmoothValues(int voice)
+    {
+        groups[voice / kSimdLanes].flushSmoothValues(voice % kSimdLanes);
+    }
+
+    // Renders every voice whose bit is set in activeMask. pwm and out hold
+    // one buffer per voice; entries for inactive voices are not touched.
+    void compute(const float *detune, const float *const *pwm, float *const *out,
+                 uint32_t activeMask, int numSamples)
+    {
+        for (int g = 0; g < kNumGroups; ++g)
+            computeGroup(g, detune, pwm, out, activeMask, numSamples);
+    }
+
+    // Renders the voices of one lane group. Groups share no state, so
+    // different groups may be computed concurrently.
+    void computeGroup(int g, const float *detune, const float *const *pwm, float *const *out,
+                      uint32_t activeMask, int numSamples)
+    {
+        uint32_t bits = (activeMask >> (g * kSimdLanes)) & ((1u << kSimdLanes) - 1);
+        if (!bits)
+            return;
+
+        const float *in[kSimdLanes];
+        float *dst[kSimdLanes];
+        for (int l = 0; l < kSimdLanes; ++l) {
+            int v = g * kSimdLanes + l;
+            bool on = (bits >> l) & 1;
+            in[l] = on ? pwm[v] : silence;
+            dst[l] = on ? out[v] : discard[g];
+        }
+        groups[g].process(detune, in, dst, numSamples, simdLaneMask(bits), SimdMask{});
+    }
+
+private:
+    HeraDCOx4 groups[kNumGroups];
+    float silence[MaxBlockSize] = {};
+    float discard[kNumGroups][MaxBlockSize];
+};
@@ -9,66 +9,156 @@
 #include <algorithm>
 #include <cassert>
 
-AbstractEnvelope::AbstractEnvelope(std::vector<EnvelopeSegment> segments)
+EnvelopeShape::EnvelopeShape(const EnvelopeSegment *segments, int numSegments)
+    : numSegments_(numSegments)
 {
-    int numSegments = (int)segments.size();
-    assert(numSegments >= 2 &&
+    assert(numSegments >= 2 && numSegments <= kMaxSegments &&
             segments[numSegments - 2].type == EnvelopeSegment::Decay &&
             segments[numSegments - 1].type == EnvelopeSegment::Shutdown);
 
-    segments_ = std::move(segments);
-    data_.resize(numSegments);
     for (int i = 0; i < numSegments; ++i) {
+        segments_[i] = segments[i];
         SegmentData &data = data_[i];
+        data = SegmentData();
         data.duration = 0;
     }
     setSampleRate(44100);
 }
 
-void AbstractEnvelope::setSampleRate(float sampleRate)
+void EnvelopeShape::setSampleRate(float sampleRate)
 {
     sampleRate_ = sampleRate;
-    int numSegments = (int)segments_.size();
-    for (int i = 0; i < numSegments; ++i)
+    for (int i = 0; i < numSegments_; ++i)
         recalculateSegment(i);
 }
 
-void AbstractEnvelope::setDuration(int segmentIndex, float duration)
+void EnvelopeShape::setDuration(int segmentIndex, float duration)
 {
     SegmentData &data = data_[segmentIndex];
+    if (data.duration == duration)
+        return;
     data.duration = duration;
     recalculateSegment(segmentIndex);
 }
 
-void AbstractEnvelope::setTarget(int segmentIndex, float target)
+void EnvelopeShape::setTarget(int segmentIndex, float target)
 {
     EnvelopeSegment &segment = segments_[segmentIndex];
+    if (segment.target == target)
+        return;
     segment.target = target;
     recalculateSegment(segmentIndex);
 }
 
+int EnvelopeShape::samplesBeforeEnd(int segmentIndex, float value, int maxRun) const
+{
+    const EnvelopeSegment &segment = segments_[segmentIndex];
+    const SegmentData &data = data_[segmentIndex];
+
+    switch (segment.type) {
+    case EnvelopeSegment::Attack:
+    case EnvelopeSegment::Decay: {
+        if (data.endless && (segment.type == EnvelopeSegment::Attack || value >= segment.target))
+            return maxRun;
+        if (segment.sustained)
+            return 0;
+
+        // value_k - fixed = (value - fixed) * coeff^k. Each float step adds
+        // at most ~2^-23 of the magnitudes involved, which must not bridge
+        // the remaining distance to the threshold.
+        double fixed = data.fixedPoint;
+        double threshold = (segment.type == EnvelopeSegment::Attack) ?
+            segment.target : std::max(segment.target, 0.02f);
+        double drift = (maxRun + 1) * 1.2e-7 * (1.0 + std::fabs(value) + std::fabs(fixed));
+        double distance = value - fixed;
+        double thresholdDistance = threshold - fixed;
+        if (distance * thresholdDistance <= 0)
+            return 0;
+        double from = std::fabs(distance);
+        double to = std::fabs(thresholdDistance) + drift;
+        if (to >= from)
+            return 0;
+        double run = std::log(to / from) / data.logCoeff - 1;
+        return (run < maxRun) ? std::max(0, (int)run) : maxRun;
+    }
+    case EnvelopeSegment::Shutdown: {
+        double drift = (maxRun + 1) * 1.2e-7 * (1.0 + std::fabs(value));
+        double run = (value - drift) / data.u.shutdown.rate - 1;
+        return (run < maxRun) ? std::max(0, (int)run) : maxRun;
+    }
+    default:
+        return 0;
+    }
+}
+
+void EnvelopeShape::recalculateSegment(int segmentIndex)
+{
+    EnvelopeSegment &segment = segments_[segmentIndex];
+    SegmentData &data = data_[segmentIndex];
+    switch (segment.type) {
+    case EnvelopeSegment::Attack: {
+        float tco = std::max(0.001f, segment.tco);
+        float samples = sampleRate_ * std::max(0.001f, data.duration);
+        data.u.ad.coeff = std::exp(-std::log((1.0f + tco) / tco) / samples);
+        data.u.ad.offset = (1.0f + tco) * (1.0f - data.u.ad.coeff);
+        data.endless = segment.sustained;
+        break;
+    }
+    case EnvelopeSegment::Decay: {
+        float tco = std::max(0.001f, segment.tco);
+        float samples = sampleRate_ * std::max(0.001f, data.duration);
+        data.u.ad.coeff = std::exp(-std::log((1.0f + tco) / tco) / samples);
+        data.u.ad.offset = (segment.target - tco) * (1.0f - data.u.ad.coeff);
+        // Held at the target, the next value is its minimum; with margin
+        // for the rounding of the recurrence it never drops below 0.02
+        float heldNext = segment.target * data.u.ad.coeff + data.u.ad.offset;
+        data.endless = segment.sustained && heldNext >= 0.02f + 1e-6f;
+        break;
+    }
+    case EnvelopeSegment::Shutdown: {
+        float tco = std::max(0.001f, segment.tco);
+        data.u.shutdown.rate = 1.0f / (tco * sampleRate_);
+        break;
+    }
+    }
+
+    if (segment.type == EnvelopeSegment::Attack || segment.type == EnvelopeSegment::Decay) {
+        double coeff = data.u.ad.coeff;
+        data.fixedPoint = data.u.ad.offset / (1.0 - coeff);
+        data.logCoeff = std::log(coeff);
+    }
+}
+
+///
+AbstractEnvelope::AbstractEnvelope(const EnvelopeShape *shape)
+    : shape_(shape)
+{
+}
+
 void AbstractEnvelope::processNextBlock(float *output, int startSample, int numSamples)
 {
+    const EnvelopeShape &shape = *shape_;
     int phase = currentPhase_;
     float value = currentValue_;
-    int numSegments = (int)segments_.size();
+    int numSegments = shape.getNumSegments();
 
     while (numSamples > 0) {
-        EnvelopeSegment *segment = nullptr;
-        SegmentData *data = nullptr;
+        const EnvelopeSegment *segment = nullptr;
+        const EnvelopeShape::SegmentData *data = nullptr;
         int sampleIndex = 0;
+        int startPhase = phase;
 
         int segmentType = -1;
         if (phase != -1) {
-            segment = &segments_[phase];
-            data = &data_[phase];
+            segment = &shape.getSegment(phase);
+            data = &shape.getData(phase);
             segmentType = segment->type;
         }
 
         switch (segmentType) {
         case EnvelopeSegment::Delay: {
-            float ts = 1.0f / sampleRate_;
-            float rem = data->u.delay.remaining;
+            float ts = 1.0f / shape.getSampleRate();
+            float rem = delayRemaining_;
             for (; sampleIndex < numSamples; ++sampleIndex) {
                 rem -= ts;
                 if (rem < 0.0f) {
@@ -78,21 +168,33 @@ void AbstractEnvelope::processNextBlock(float *output, int startSample, int numS
                 value = 0.0f;
                 output[startSample + sampleIndex] = 0.0f;
             }
-            data->u.delay.remaining = rem;
+            delayRemaining_ = rem;
             break;
         }
+        // Attack, decay and shutdown alternate a run with no end test, as
+        // long as samplesBeforeEnd allows, with a few tested samples
         case EnvelopeSegment::Attack: {
             bool sustained = segment->sustained;
             float target = segment->target;
             auto ad = data->u.ad;
-            for (; sampleIndex < numSamples; ++sampleIndex) {
-                float next = value * ad.coeff + ad.offset;
-                if (next > target && !sustained) {
-                    phase = (phase + 1 < numSegments) ? (phase + 1) : -1;
-                    break;
+            bool ended = false;
+            while (!ended && sampleIndex < numSamples) {
+                int run = shape.samplesBeforeEnd(phase, value, numSamples - sampleIndex);
+                for (int end = sampleIndex + run; sampleIndex < end; ++sampleIndex) {
+                    value = std::min(target, value * ad.coeff + ad.offset);
+                    output[startSample + sampleIndex] = value;
+                }
+                int checkedEnd = std::min(numSamples, sampleIndex + EnvelopeShape::kCheckedSamples);
+                for (; sampleIndex < checkedEnd; ++sampleIndex) {
+                    float next = value * ad.coeff + ad.offset;
+                    if (next > target && !sustained) {
+                        phase = (phase + 1 < numSegments) ? (phase + 1) : -1;
+                        ended = true;
+                        break;
+                    }
+                    value = std::min(target, next);
+                    output[startSample + sampleIndex] = value;
                 }
-                value = std::min(target, next);
-                output[startSample + sampleIndex] = value;
             }
             break;
         }
@@ -100,27 +202,47 @@ void AbstractEnvelope::processNextBlock(float *output, int startSample, int numS
             bool sustained = segment->sustained;
             float target = segment->target;
             auto ad = data->u.ad;
-            for (; sampleIndex < numSamples; ++sampleIndex) {
-                float next = value * ad.coeff + ad.offset;
-                if ((next <= target && !sustained) || next < 0.02f) {
-                    phase = (phase + 1 < numSegments) ? (phase + 1) : -1;
-                    break;
+            bool ended = false;
+            while (!ended && sampleIndex < numSamples) {
+                int run = shape.samplesBeforeEnd(phase, value, numSamples - sampleIndex);
+                for (int end = sampleIndex + run; sampleIndex < end; ++sampleIndex) {
+                    value = std::max(target, value * ad.coeff + ad.offset);
+                    output[startSample + sampleIndex] = value;
+                }
+                int checkedEnd = std::min(numSamples, sampleIndex + EnvelopeShape::kCheckedSamples);
+                for (; sampleIndex < checkedEnd; ++sampleIndex) {
+                    float next = value * ad.coeff + ad.offset;
+                    if ((next <= target && !sustained) || next < 0.02f) {
+                        phase = (phase + 1 < numSegments) ? (phase + 1) : -1;
+                        ended = true;
+                        break;
+                    }
+                    value = std::max(target, next);
+                    output[startSample + sampleIndex] = value;
                 }
-                value = std::max(target, next);
-                output[startSample + sampleIndex] = value;
             }
             break;
         }
         case EnvelopeSegment::Shutdown: {
             float rate = data->u.shutdown.rate;
-            for (; sampleIndex < numSamples; ++sampleIndex) {
-                float next = value - rate;
-                if (next <= 0.0f) {
-                    phase = (phase + 1 < numSegments) ? (phase + 1) : -1;
-                    break;
+            bool ended = false;
+            while (!ended && sampleIndex < numSamples) {
+                int run = shape.samplesBeforeEnd(phase, value, numSamples - sampleIndex);
+                for (int end = sampleIndex + run; sampleIndex < end; ++sampleIndex) {
+                    value = std::max(0.0f, value - rate);
+                    output[startSample + sampleIndex] = value;
+                }
+                int checkedEnd = std::min(numSamples, sampleIndex + EnvelopeShape::kCheckedSamples);
+                for (; sampleIndex < checkedEnd; ++sampleIndex) {
+                    float next = value - rate;
+                    if (next <= 0.0f) {
+                        phase = (phase + 1 < numSegments) ? (phase + 1) : -1;
+                        ended = true;
+                        break;
+                    }
+                    value = std::max(0.0f, next);
+                    output[startSample + sampleIndex] = value;
                 }
-                value = std::max(0.0f, next);
-                output[startSample + sampleIndex] = value;
             }
             break;
         }
@@ -132,6 +254,9 @@ void AbstractEnvelope::processNextBlock(float *output, int startSample, int numS
             break;
         }
 
+        if (phase != startPhase && phase != -1)
+            enterSegment(phase);
+
         startSample += sampleIndex;
         numSamples -= sampleIndex;
     }
@@ -162,78 +287,47 @@ void AbstractEnvelope::reset()
 {
     currentPhase_ = -1;
     currentValue_ = 0.0;
-    int numSegments = (int)segments_.size();
-    for (int i = 0; i < numSegments; ++i)
-        resetSegment(i);
+    delayRemaining_ = 0.0;
 }
 
 void AbstractEnvelope::noteOn()
 {
-    int numSegments = (int)segments_.size();
-    for (int i = 0; i < numSegments; ++i)
-        resetSegment(i);
     currentPhase_ = 0;
+    enterSegment(0);
 }
 
 void AbstractEnvelope::noteOff()
 {
-    int numSegments = (int)segments_.size();
+    int numSegments = shape_->getNumSegments();
     if (currentPhase_ != -1)
         currentPhase_ = std::max(currentPhase_, numSegments - 2);
 }
 
 bool AbstractEnvelope::isReleased() const
 {
-    int numSegments = (int)segments_.size();
+    int numSegments = shape_->getNumSegments();
     return currentPhase_ == -1 || currentPhase_ >= numSegments - 2;
 }
 
 void AbstractEnvelope::shutdown()
 {
-    int numSegments = (int)segments_.size();
+    int numSegments = shape_->getNumSegments();
     if (currentPhase_ != -1)
         currentPhase_ = std::max(currentPhase_, numSegments - 1);
 }
 
-void AbstractEnvelope::recalculateSegment(int segmentIndex)
+// Called when the shape's delay duration has changed: a running delay
+// starts over with the new duration, as if it had just been entered
+void AbstractEnvelope::restartDelay()
 {
-    EnvelopeSegment &segment = segments_[segmentIndex];
-    SegmentData &data = data_[segmentIndex];
-    switch (segment.type) {
-    case EnvelopeSegment::Delay:
-        data.u.delay.remaining = data.duration;
-        break;
-    case EnvelopeSegment::Attack: {
-        float tco = std::max(0.001f, segment.tco);
-        float samples = sampleRate_ * std::max(0.001f, data.duration);
-        data.u.ad.coeff = std::exp(-std::log((1.0f + tco) / tco) / samples);
-        data.u.ad.offset = (1.0f + tco) * (1.0f - data.u.ad.coeff);
-        break;
-    }
-    case EnvelopeSegment::Decay: {
-        float tco = std::max(0.001f, segment.tco);
-        float samples = sampleRate_ * std::max(0.001f, data.duration);
-        data.u.ad.coeff = std::exp(-std::log((1.0f + tco) / tco) / samples);
-        data.u.ad.offset = (segment.target - tco) * (1.0f - data.u.ad.coeff);
-        break;
-    }
-    case EnvelopeSegment::Shutdown: {
-        float tco = std::max(0.001f, segment.tco);
-        data.u.shutdown.rate = 1.0f / (tco * sampleRate_);
-        break;
-    }
-    }
+    if (currentPhase_ != -1 && shape_->getSegment(currentPhase_).type == EnvelopeSegment::Delay)
+        enterSegment(currentPhase_);
 }
 
-void AbstractEnvelope::resetSegment(int segmentIndex)
+void AbstractEnvelope::enterSegment(int segmentIndex)
 {
-    EnvelopeSegment &segment = segments_[segmentIndex];
-    SegmentData &data = data_[segmentIndex];
-    switch (segment.type) {
-    case EnvelopeSegment::Delay:
-        data.u.delay.remaining = data.duration;
-        break;
-    }
+    if (shape_->getSegment(segmentIndex).type == EnvelopeSegment::Delay)
+        delayRemaining_ = shape_->getData(segmentIndex).duration;
 }
 
 ///
@@ -245,46 +339,58 @@ static const std::array<EnvelopeSegment, 4> kHeraSegments {{
 }};
 
 ///
-HeraEnvelope::HeraEnvelope()
-    : envelope(std::vector<EnvelopeSegment>(kHeraSegments.begin(), kHeraSegments.end()))
+HeraEnvelopeShape::HeraEnvelopeShape()
+    : shape(kHeraSegments)
 {
     recalculateValues();
 }
 
-void HeraEnvelope::setSampleRate(float sampleRate)
+void HeraEnvelopeShape::setSampleRate(float sampleRate)
 {
-    envelope.setSampleRate(sampleRate);
+    shape.setSampleRate(sampleRate);
 }
 
-void HeraEnvelope::setAttack(float value)
+void HeraEnvelopeShape::setAttack(float value)
 {
     attackDuration = curveFromAttackSliderToDuration(value);
     recalculateValues();
 }
 
-void HeraEnvelope::setDecay(float value)
+void HeraEnvelopeShape::setDecay(float value)
 {
     decayDuration = curveFromDecaySliderToDuration(value);
     recalculateValues();
 }
 
-void HeraEnvelope::setSustain(float value)
+void HeraEnvelopeShape::setSustain(float value)
 {
     sustainLevel = value;
     recalculateValues();
 }
 
-void HeraEnvelope::setRelease(float value)
+void HeraEnvelopeShape::setRelease(float value)
 {
     releaseDuration = curveFromReleaseSliderToDuration(value);
     recalculateValues();
 }
 
-void HeraEnvelope::recalculateValues()
+void HeraEnvelopeShape::recalculateValues()
 {
     float decayTarget = std::max(0.02f, sustainLevel);
-    envelope.setDuration(0, attackDuration);
-    envelope.setTarget(1, decayTarget);
-    envelope.setDuration(1, decayDuration);
-    envelope.setDuration(2, (decayTarget <= 0.02f) ? 0.01f : releaseDuration);
+    shape.setDuration(0, attackDuration);
+    shape.setTarget(1, decayTarget);
+    shape.setDuration(1, decayDuration);
+    shape.setDuration(2, (decayTarget <= 0.02f) ? 0.01f : releaseDuration);
+}
+
+///
+static const HeraEnvelopeShape &defaultHeraEnvelopeShape()
+{
+    static const HeraEnvelopeShape shape;
+    return shape;
+}
+
+HeraEnvelope::HeraEnvelope()
+    : envelope(defaultHeraEnvelopeShape().getShape())
+{
 }
@@ -2,7 +2,7 @@
 // Modified for Move Anything: JUCE dependencies removed
 
 #pragma once
-#include <vector>
+#include <array>
 #include <cassert>
 #include <algorithm>
 
@@ -14,56 +14,104 @@ struct EnvelopeSegment {
     bool sustained = false;
 };
 
-class AbstractEnvelope {
+// Segment list and the coefficients derived from it. One shape can drive
+// any number of envelopes, so coefficients are computed once per change.
+// Segments are stored inline, up to kMaxSegments.
+class EnvelopeShape {
 public:
-    explicit AbstractEnvelope(std::vector<EnvelopeSegment> segments);
+    static constexpr int kMaxSegments = 4;
+
+    struct SegmentData {
+        float duration;
+        union {
+            struct { float coeff; float offset; } ad;
+            struct { float rate; } shutdown;
+        } u;
+        double fixedPoint;  // Attack/Decay: limit of value * coeff + offset
+        double logCoeff;    // Attack/Decay: log(coeff)
+        bool endless;       // Sustained: the end test can never pass
+    };
+
+    // Samples advanced with the end test before samplesBeforeEnd is asked again
+    static constexpr int kCheckedSamples = 8;
+
+    // Empty until assigned from a shape built from segments
+    EnvelopeShape() = default;
+
+    template <size_t N>
+    explicit EnvelopeShape(const std::array<EnvelopeSegment, N> &segments)
+        : EnvelopeShape(segments.data(), (int)N)
+    {
+        static_assert(N >= 2 && N <= kMaxSegments, "unsupported envelope segment count");
+    }
+
     void setSampleRate(float sampleRate);
     void setDuration(int segmentIndex, float duration);
     void setTarget(int segmentIndex, float target);
+    float getSampleRate() const { return sampleRate_; }
+    int getNumSegments() const { return numSegments_; }
+    const EnvelopeSegment &getSegment(int segmentIndex) const { return segments_[segmentIndex]; }
+    const SegmentData &getData(int segmentIndex) const { return data_[segmentIndex]; }
+
+    // How many of the next maxRun samples segmentIndex can produce from
+    // `value` without reaching its end, so they can be computed with no end
+    // test. Conservative: float rounding of the recurrence is accounted for,
+    // so the sample where the segment really ends is never inside the run.
+    // There is no tolerance: envelopes rendered with these runs are
+    // bit-identical to testing the end at every sample, including phase
+    // changes (tests/test_envelope_segments.cpp).
+    int samplesBeforeEnd(int segmentIndex, float value, int maxRun) const;
+
+private:
+    EnvelopeShape(const EnvelopeSegment *segments, int numSegments);
+    void recalculateSegment(int segmentIndex);
+
+private:
+    float sampleRate_ = 0;
+    int numSegments_ = 0;
+    EnvelopeSegment segments_[kMaxSegments];
+    SegmentData data_[kMaxSegments];
+};
+
+// Playback state of one envelope, following a shape it does not own
+class AbstractEnvelope {
+public:
+    explicit AbstractEnvelope(const EnvelopeShape *shape);
+    void setShape(const EnvelopeShape *shape) { shape_ = shape; }
     void processNextBlock(float *output, int startSample, int numSamples);
     void applyEnvelopeToBuffer(float *buffer, int startSample, int numSamples);
     void reset();
     void noteOn();
     void noteOff();
     void shutdown();
+    void restartDelay();
     bool isActive() const { return currentPhase_ != -1; }
     bool isReleased() const;
+    float getCurrentValue() const { return currentValue_; }
 
 private:
-    void recalculateSegment(int segmentIndex);
-    void resetSegment(int segmentIndex);
+    friend class AbstractEnvelopex4;
+    void enterSegment(int segmentIndex);
 
 private:
-    struct SegmentData {
-        float duration;
-        union {
-            struct { float remaining; } delay;
-            struct { float coeff; float offset; } ad;
-            struct { float rate; } shutdown;
-        } u;
-    };
-    float sampleRate_ = 0;
+    const EnvelopeShape *shape_ = nullptr;
     int currentPhase_ = -1;
     float currentValue_ = 0.0;
-    std::vector<EnvelopeSegment> segments_;
-    std::vector<SegmentData> data_;
+    // Seconds left in a Delay segment. Set on entering it, and restarted
+    // from the shape's duration by restartDelay() when that changes.
+    float delayRemaining_ = 0.0;
 };
 
-class HeraEnvelope {
+// ADSR settings of the Hera envelope, shared by every voice using them
+class HeraEnvelopeShape {
 public:
-    HeraEnvelope();
+    HeraEnvelopeShape();
     void setSampleRate(float sampleRate);
     void setAttack(float value);
     void setDecay(float value);
     void setSustain(float value);
     void setRelease(float value);
-    void processNextBlock(float *output, int startSample, int numSamples) { envelope.processNextBlock(output, startSample, numSamples); }
-    void reset() { envelope.reset(); }
-    void noteOn() { envelope.noteOn(); }
-    void noteOff() { envelope.noteOff(); }
-    void shutdown() { envelope.shutdown(); }
-    bool isActive() const { return envelope.isActive(); }
-    bool isReleased() const { return envelope.isReleased(); }
+    const EnvelopeShape *getShape() const { return &shape; }
 
 private:
     void recalculateValues();
@@ -73,5 +121,23 @@ private:
     float decayDuration = 0;
     float sustainLevel = 0;
     float releaseDuration = 0;
+    EnvelopeShape shape;
+};
+
+class HeraEnvelope {
+public:
+    HeraEnvelope();
+    void setShape(const HeraEnvelopeShape *shape) { envelope.setShape(shape->getShape()); }
+    void processNextBlock(float *output, int startSample, int numSamples) { envelope.processNextBlock(output, startSample, numSamples); }
+    void reset() { envelope.reset(); }
+    void noteOn() { envelope.noteOn(); }
+    void noteOff() { envelope.noteOff(); }
+    void shutdown() { envelope.shutdown(); }
+    bool isActive() const { return envelope.isActive(); }
+    bool isReleased() const { return envelope.isReleased(); }
+    float getCurrentValue() const { return envelope.getCurrentValue(); }
+    AbstractEnvelope *getAbstractEnvelope() { return &envelope; }
+
+private:
     AbstractEnvelope envelope;
 };
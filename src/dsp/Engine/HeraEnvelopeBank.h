@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Move Anything: voice-parallel AbstractEnvelope processing
+//
+// Advances up to four envelopes that follow the same shape, one per SIMD
+// lane. The attack, decay and shutdown segments are all value * mul + add
+// followed by a clamp and a transition test, so lanes in different segments
+// step together. As in AbstractEnvelope::processNextBlock, runs that no lane
+// can end in skip the transition test. A lane that changes segment finishes
+// that sample on the scalar path, exactly as processNextBlock would, then
+// rejoins with the new segment's coefficients.
+//
+// Delay segments are not handled here; the voice envelopes have none.
+
+#pragma once
+#include "HeraEnvelope.h"
+#include "SimdLanes.h"
+
+class AbstractEnvelopex4 {
+public:
+    // envelopes[l] may be null for an unused lane; output[l] is then ignored.
+    static void process(AbstractEnvelope *const *envelopes, float *const *output, int count)
+    {
+        const EnvelopeShape *shape = nullptr;
+        for (int l = 0; l < kSimdLanes; ++l) {
+            if (envelopes[l]) {
+                assert(!shape || shape == envelopes[l]->shape_);
+                shape = envelopes[l]->shape_;
+            }
+        }
+        if (!shape)
+            return;
+
+        Lanes lanes;
+        for (int l = 0; l < kSimdLanes; ++l) {
+            const AbstractEnvelope *env = envelopes[l];
+            lanes.phase[l] = env ? env->currentPhase_ : -1;
+            lanes.value[l] = env ? env->currentValue_ : 0.0f;
+            lanes.load(*shape, l);
+        }
+
+        int i = 0;
+        while (i < count) {
+            // Run with no end test while no lane can reach its segment end
+            int run = count - i;
+            for (int l = 0; l < kSimdLanes; ++l) {
+                if (lanes.phase[l] != -1)
+                    run = std::min(run, shape->samplesBeforeEnd(lanes.phase[l], lanes.value[l], run));
+            }
+            for (int end = i + run; i < end; ++i) {
+                SimdFloat next = lanes.value * lanes.mul + lanes.add;
+                lanes.value = simdSelect(lanes.rising, simdMin(next, lanes.target),
+                                         simdMax(next, lanes.target));
+                for (int l = 0; l < kSimdLanes; ++l)
+                    if (envelopes[l]) output[l][i] = lanes.value[l];
+            }
+
+            int checkedEnd = std::min(count, i + EnvelopeShape::kCheckedSamples);
+            for (; i < checkedEnd; ++i) {
+                SimdFloat next = lanes.value * lanes.mul + lanes.add;
+                SimdMask rising = lanes.rising & (next > lanes.target);
+                SimdMask falling = ~lanes.rising & (next <= lanes.target);
+                SimdMask transition = (rising | falling) & ~lanes.sustained;
+                transition |= ~lanes.rising & (next < lanes.decayFloor);
+                SimdFloat value = simdSelect(lanes.rising, simdMin(next, lanes.target),
+                                             simdMax(next, lanes.target));
+
+                if (simdAny(transition)) {
+                    for (int l = 0; l < kSimdLanes; ++l) {
+                        if (transition[l]) {
+                            float laneValue = lanes.value[l];
+                            value[l] = finishSample(*shape, lanes.phase[l], laneValue);
+                            lanes.load(*shape, l);
+                        }
+                    }
+                }
+
+                lanes.value = value;
+                for (int l = 0; l < kSimdLanes; ++l)
+                    if (envelopes[l]) output[l][i] = value[l];
+            }
+        }
+
+        for (int l = 0; l < kSimdLanes; ++l) {
+            if (envelopes[l]) {
+                envelopes[l]->currentPhase_ = lanes.phase[l];
+                envelopes[l]->currentValue_ = lanes.value[l];
+            }
+        }
+    }
+
+private:
+    // Per-lane segment coefficients, reloaded only when a lane's phase changes
+    struct Lanes {
+        int phase[kSimdLanes];
+        SimdFloat value;
+        SimdFloat mul, add, target, decayFloor;
+        SimdMask rising, sustained;
+
+        void load(const EnvelopeShape &shape, int l)
+        {
+            // Idle (-1): a sustained fall to 0 that never transitions
+            mul[l] = 0.0f;
+            add[l] = 0.0f;
+            target[l] = 0.0f;
+            decayFloor[l] = 0.0f;
+            rising[l] = 0;
+            sustained[l] = -1;
+
+            int phase = this->phase[l];
+            if (phase == -1)
+                return;
+
+            const EnvelopeSegment &segment = shape.getSegment(phase);
+            const EnvelopeShape::SegmentData &data = shape.getData(phase);
+            switch (segment.type) {
+            case EnvelopeSegment::Attack:
+                mul[l] = data.u.ad.coeff;
+                add[l] = data.u.ad.offset;
+                target[l] = segment.target;
+                rising[l] = -1;
+                sustained[l] = segment.sustained ? -1 : 0;
+                break;
+            case EnvelopeSegment::Decay:
+                mul[l] = data.u.ad.coeff;
+                add[l] = data.u.ad.offset;
+                target[l] = segment.target;
+                decayFloor[l] = 0.02f;
+                sustained[l] = segment.sustained ? -1 : 0;
+                break;
+            case EnvelopeSegment::Shutdown:
+                mul[l] = 1.0f;
+                add[l] = -data.u.shutdown.rate;
+                sustained[l] = 0;
+                break;
+            default:
+                assert(false);
+                break;
+            }
+        }
+    };
+
+    // One sample of AbstractEnvelope::processNextBlock, starting with the
+    // transition out of `phase`. Returns the sample; updates phase and value.
+    static float finishSample(const EnvelopeShape &shape, int &phase, float &value)
+    {
+        int numSegments = shape.getNumSegments();
+        for (;;) {
+            phase = (phase + 1 < numSegments) ? (phase + 1) : -1;
+            if (phase == -1)
+                return value = 0.0f;
+
+            const EnvelopeSegment &segment = shape.getSegment(phase);
+            const EnvelopeShape::SegmentData &data = shape.getData(phase);
+            switch (segment.type) {
+            case EnvelopeSegment::Attack: {
+                float next = value * data.u.ad.coeff + data.u.ad.offset;
+                if (next > segment.target && !segment.sustained)
+                    continue;
+                return value = std::min(segment.target, next);
+            }
+            case EnvelopeSegment::Decay: {
+                float next = value * data.u.ad.coeff + data.u.ad.offset;
+                if ((next <= segment.target && !segment.sustained) || next < 0.02f)
+                    continue;
+                return value = std::max(segment.target, next);
+            }
+            case EnvelopeSegment::Shutdown: {
+                float next = value - data.u.shutdown.rate;
+                if (next <= 0.0f)
+                    continue;
+                return value = std::max(0.0f, next);
+            }
+            default:
+                assert(false);
+                return value = 0.0f;
+            }
+        }
+    }
+};
@@ -13,15 +13,17 @@ static const std::array<EnvelopeSegment, 4> kHeraLFOSegments {{
 }};
 
 HeraLFOWithEnvelope::HeraLFOWithEnvelope()
-    : envelope(std::vector<EnvelopeSegment>(kHeraLFOSegments.begin(), kHeraLFOSegments.end()))
+    : envelopeShape(kHeraLFOSegments),
+      envelope(&envelopeShape)
 {
-    envelope.setDuration(2, 0.1f);
+    envelopeShape.setDuration(2, 0.1f);
 }
 
 void HeraLFOWithEnvelope::setSampleRate(double newRate)
 {
     lfo.setSampleRate(newRate);
-    envelope.setSampleRate(newRate);
+    envelopeShape.setSampleRate(newRate);
+    envelope.restartDelay();
 }
 
 void HeraLFOWithEnvelope::processBlock(float *output, int numFrames)
@@ -45,10 +47,21 @@ void HeraLFOWithEnvelope::noteOn()
 
 void HeraLFOWithEnvelope::setDelayDuration(float duration)
 {
-    envelope.setDuration(0, duration);
+    if (envelopeShape.getData(0).duration == duration)
+        return;
+    envelopeShape.setDuration(0, duration);
+    envelope.restartDelay();
 }
 
 void HeraLFOWithEnvelope::setAttackDuration(float duration)
 {
-    envelope.setDuration(1, duration);
+    envelopeShape.setDuration(1, duration);
+}
+
+void HeraLFOWithEnvelope::setEnvelopeShape(const EnvelopeShape &shape)
+{
+    bool delayChanged = shape.getData(0).duration != envelopeShape.getData(0).duration;
+    envelopeShape = shape;
+    if (delayChanged)
+        envelope.restartDelay();
 }
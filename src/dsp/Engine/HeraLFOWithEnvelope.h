@@ -8,6 +8,8 @@
 class HeraLFOWithEnvelope {
 public:
     HeraLFOWithEnvelope();
+    HeraLFOWithEnvelope(const HeraLFOWithEnvelope &) = delete;
+    HeraLFOWithEnvelope &operator=(const HeraLFOWithEnvelope &) = delete;
     void setSampleRate(double newRate);
     void processBlock(float *output, int numFrames);
     void reset() { lfo.reset(); envelope.reset(); }
@@ -20,7 +22,12 @@ public:
     void setAttackDuration(float duration);
     bool isActive() const { return envelope.isActive(); }
 
+    // Delay/attack coefficients, so they can be computed ahead and copied in
+    const EnvelopeShape &getEnvelopeShape() const { return envelopeShape; }
+    void setEnvelopeShape(const EnvelopeShape &shape);
+
 private:
     HeraLFO lfo;
+    EnvelopeShape envelopeShape;
     AbstractEnvelope envelope;
 };
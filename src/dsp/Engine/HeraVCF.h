@@ -2,5 +2,9 @@
 
 #pragma once
 #include "VCF/JpcVCF.h"
+#include "VCF/JpcVCFBank.h"
 
 using HeraVCF = HeraVCF_Jpc;
+
+template <int NumVoices, int MaxBlockSize>
+using HeraVCFBank = JpcVCFBank<NumVoices, MaxBlockSize>;
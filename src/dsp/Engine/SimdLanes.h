@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Move Anything: 4-lane float/int vectors for voice-parallel DSP kernels
+
+#pragma once
+#include <stdint.h>
+
+#if !defined(__GNUC__)
+#error "SimdLanes.h requires GCC/Clang vector extensions"
+#endif
+
+// One lane per voice. GCC lowers these to NEON on aarch64 and to SSE on x86.
+static constexpr int kSimdLanes = 4;
+
+typedef float SimdFloat __attribute__((vector_size(16)));
+typedef int32_t SimdInt __attribute__((vector_size(16)));
+typedef uint32_t SimdUInt __attribute__((vector_size(16)));
+
+// Comparisons yield all-ones (-1) or all-zeros per lane.
+typedef SimdInt SimdMask;
+
+static inline SimdFloat simdSplat(float x)
+{
+    return SimdFloat{x, x, x, x};
+}
+
+static inline SimdFloat simdSelect(SimdMask mask, SimdFloat a, SimdFloat b)
+{
+    return (SimdFloat)(((SimdInt)a & mask) | ((SimdInt)b & ~mask));
+}
+
+static inline SimdFloat simdMax(SimdFloat a, SimdFloat b)
+{
+    return simdSelect(a > b, a, b);
+}
+
+static inline SimdFloat simdMin(SimdFloat a, SimdFloat b)
+{
+    return simdSelect(a < b, a, b);
+}
+
+// float(int(x)): truncation toward zero, as in the generated scalar code
+static inline SimdFloat simdTrunc(SimdFloat x)
+{
+    return __builtin_convertvector(__builtin_convertvector(x, SimdInt), SimdFloat);
+}
+
+static inline SimdInt simdToInt(SimdFloat x)
+{
+    return __builtin_convertvector(x, SimdInt);
+}
+
+static inline SimdFloat simdToFloat(SimdInt x)
+{
+    return __builtin_convertvector(x, SimdFloat);
+}
+
+// Expand the low 4 bits of `bits` into a per-lane mask
+static inline SimdMask simdLaneMask(uint32_t bits)
+{
+    SimdInt b = SimdInt{1, 2, 4, 8} & (int32_t)bits;
+    return b != 0;
+}
+
+static inline bool simdAny(SimdMask mask)
+{
+    return (mask[0] | mask[1] | mask[2] | mask[3]) != 0;
+}
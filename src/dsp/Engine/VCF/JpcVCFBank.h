@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: ISC
+// Move Anything: voice-parallel port of JpcVCF.hxx
+//
+// Four voices of the 4-stage ladder per SIMD register, so the four tanh
+// lookups and divisions of each stage cover four voices at once. The table
+// is the one JpcVCF::classInit fills; lookups are gathered per lane.
+
+#pragma once
+#include "JpcVCF.hxx"
+#include "../SimdLanes.h"
+
+class JpcVCFx4 {
+public:
+    void init(int sample_rate)
+    {
+        JpcVCF::classInit(sample_rate);
+        fConst1 = (6.28318548f / float(sample_rate));
+        fConst2 = (3.14159274f / float(sample_rate));
+        for (int l = 0; l < kSimdLanes; ++l)
+            clearLane(l);
+    }
+
+    void clearLane(int lane)
+    {
+        iRec10[lane] = 0;
+        fRec8[lane] = fRec6[lane] = fRec4[lane] = fRec1[lane] = fRec0[lane] = 0.0f;
+    }
+
+    // In-place: io holds the input on entry and the output on return.
+    void process(float *const *io, const float *const *cutoff, const float *const *resonance,
+                 int count, SimdMask active)
+    {
+        const float fConst1 = this->fConst1;
+        const float fConst2 = this->fConst2;
+        SimdUInt i10 = (SimdUInt)iRec10;
+        SimdFloat r8 = fRec8, r6 = fRec6, r4 = fRec4, r1 = fRec1, r0 = fRec0;
+
+        for (int i = 0; i < count; ++i) {
+            SimdFloat fTemp0 = SimdFloat{ io[0][i], io[1][i], io[2][i], io[3][i] };
+            SimdFloat fTemp1 = SimdFloat{ cutoff[0][i], cutoff[1][i], cutoff[2][i], cutoff[3][i] };
+            SimdFloat fTemp2 = SimdFloat{ resonance[0][i], resonance[1][i], resonance[2][i], resonance[3][i] };
+            SimdFloat fTemp5 = tanhLookup(21.166666f * (r0 + 3.0f));
+            i10 = ((1103515245u * i10) + 12345u);
+            SimdFloat fTemp6 = (4.65661276e-14f * simdToFloat((SimdInt)i10));
+            SimdFloat fTemp9 = tanhLookup(21.166666f * ((fTemp0 + ((fTemp5 * (0.0f - (4.0f * fTemp2))) + fTemp6)) + 3.0f));
+            SimdFloat fTemp10 = ((fConst2 * fTemp1) + 1.0f);
+
+            SimdFloat fTemp11 = ((fTemp1 * (fTemp9 - r8)) / fTemp10);
+            SimdFloat fRec9 = (r8 + (fConst2 * fTemp11));
+            r8 = (r8 + (fConst1 * fTemp11));
+
+            SimdFloat fTemp15 = ((fTemp1 * (tanhLookup(21.166666f * ((fRec9 + fTemp6) + 3.0f)) - r6)) / fTemp10);
+            SimdFloat fRec7 = (r6 + (fConst2 * fTemp15));
+            r6 = (r6 + (fConst1 * fTemp15));
+
+            SimdFloat fTemp19 = ((fTemp1 * (tanhLookup(21.166666f * ((fRec7 + fTemp6) + 3.0f)) - r4)) / fTemp10);
+            SimdFloat fRec5 = (r4 + (fConst2 * fTemp19));
+            r4 = (r4 + (fConst1 * fTemp19));
+
+            SimdFloat fTemp23 = ((fTemp1 * (tanhLookup(21.166666f * ((fRec5 + fTemp6) + 3.0f)) - r1)) / fTemp10);
+            SimdFloat fRec2 = (r1 + (fConst2 * fTemp23));
+            r1 = (r1 + (fConst1 * fTemp23));
+
+            r0 = fRec2;
+            io[0][i] = r0[0];
+            io[1][i] = r0[1];
+            io[2][i] = r0[2];
+            io[3][i] = r0[3];
+        }
+
+        iRec10 = (SimdInt)((SimdUInt)active & i10) | (~active & iRec10);
+        fRec8 = simdSelect(active, r8, fRec8);
+        fRec6 = simdSelect(active, r6, fRec6);
+        fRec4 = simdSelect(active, r4, fRec4);
+        fRec1 = simdSelect(active, r1, fRec1);
+        fRec0 = simdSelect(active, r0, fRec0);
+    }
+
+private:
+    // Linear interpolation in the 128-point tanh table, position in points
+    static SimdFloat tanhLookup(SimdFloat pos)
+    {
+        SimdInt i0 = simdToInt(pos);
+        SimdFloat frac = (pos - simdToFloat(i0));
+        SimdInt i1 = i0 + 1;
+        i0 = (i0 < 0) ? SimdInt{} : i0;
+        i0 = (i0 > 127) ? SimdInt{} + 127 : i0;
+        i1 = (i1 < 0) ? SimdInt{} : i1;
+        i1 = (i1 > 127) ? SimdInt{} + 127 : i1;
+        const float *t = ftbl0JpcVCFSIG0;
+        SimdFloat y0 = SimdFloat{ t[i0[0]], t[i0[1]], t[i0[2]], t[i0[3]] };
+        SimdFloat y1 = SimdFloat{ t[i1[0]], t[i1[1]], t[i1[2]], t[i1[3]] };
+        return (y0 + (frac * (y1 - y0)));
+    }
+
+private:
+    float fConst1 = 0.0f;
+    float fConst2 = 0.0f;
+    SimdInt iRec10 = {};
+    SimdFloat fRec8 = {};
+    SimdFloat fRec6 = {};
+    SimdFloat fRec4 = {};
+    SimdFloat fRec1 = {};
+    SimdFloat fRec0 = {};
+};
+
+template <int NumVoices, int MaxBlockSize>
+class JpcVCFBank {
+public:
+    static constexpr int kNumGroups = (NumVoices + kSimdLanes - 1) / kSimdLanes;
+
+    void init(int sample_rate)
+    {
+        for (JpcVCFx4 &g : groups)
+            g.init(sample_rate);
+    }
+
+    void clearVoice(int voice)
+    {
+        groups[voice / kSimdLanes].clearLane(voice % kSimdLanes);
+    }
+
+    // Filters in place every voice whose bit is set in activeMask.
+    // Buffers of inactive voices are not touched.
+    void processNextBlock(float *const *inputAndOutput, const float *const *cutoff,
+                          const float *const *resonance, uint32_t activeMask, int numSamples)
+    {
+        for (int g = 0; g < kNumGroups; ++g)
+            processGroup(g, inputAndOutput, cutoff, resonance, activeMask, numSamples);
+    }
+
+    // Filters the voices of one lane group. Groups share no state, so
+    // different groups may be processed concurrently.
+    void processGroup(int g, float *const *inputAndOutput, const float *const *cutoff,
+                      const float *const *resonance, uint32_t activeMask, int numSamples)
+    {
+        uint32_t bits = (activeMask >> (g * kSimdLanes)) & ((1u << kSimdLanes) - 1);
+        if (!bits)
+            return;
+
+        float *io[kSimdLanes];
+        const float *fc[kSimdLanes];
+        const float *res[kSimdLanes];
+        for (int l = 0; l < kSimdLanes; ++l) {
+            int v = g * kSimdLanes + l;
+            bool on = (bits >> l) & 1;
+            io[l] = on ? inputAndOutput[v] : scratch[g][l];
+            fc[l] = on ? cutoff[v] : silence;
+            res[l] = on ? resonance[v] : silence;
+        }
+        groups[g].process(io, fc, res, numSamples, simdLaneMask(bits));
+    }
+
+private:
+    JpcVCFx4 groups[kNumGroups];
+    float silence[MaxBlockSize] = {};
+    float scratch[kNumGroups][kSimdLanes][MaxBlockSize] = {};
+};
@@ -13,9 +13,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <ctype.h>
 #include <math.h>
+#include <time.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sched.h>
+#include <pthread.h>
 #include <algorithm>
+#include <string>
+#include <vector>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <thread>
 
 /* Include plugin API */
 extern "C" {
@@ -41,6 +55,14 @@ typedef struct host_api_v1 {
 
 #define MOVE_PLUGIN_API_VERSION_2 2
 
+/* MIDI event stamped with its position in the next render_block call */
+typedef struct move_midi_event {
+    uint32_t frame;     /* Sample offset within the next block */
+    uint8_t source;
+    uint8_t len;
+    uint8_t msg[3];
+} move_midi_event_t;
+
 typedef struct plugin_api_v2 {
     uint32_t api_version;
     void* (*create_instance)(const char *module_dir, const char *json_defaults);
@@ -50,6 +72,9 @@ typedef struct plugin_api_v2 {
     int (*get_param)(void *instance, const char *key, char *buf, int buf_len);
     int (*get_error)(void *instance, char *buf, int buf_len);
     void (*render_block)(void *instance, int16_t *out_interleaved_lr, int frames);
+    /* Optional, appended: queue events for sample-accurate rendering in the
+       next render_block. Hosts that do not know it keep using on_midi. */
+    void (*on_midi_batch)(void *instance, const move_midi_event_t *events, int count);
 } plugin_api_v2_t;
 
 typedef plugin_api_v2_t* (*move_plugin_init_v2_fn)(const host_api_v1_t *host);
@@ -58,8 +83,9 @@ typedef plugin_api_v2_t* (*move_plugin_init_v2_fn)(const host_api_v1_t *host);
 
 /* Hera Engine includes */
 #include "Engine/HeraEnvelope.h"
+#include "Engine/HeraEnvelopeBank.h"
 #include "Engine/HeraLFOWithEnvelope.h"
-#include "Engine/HeraDCO.hxx"
+#include "Engine/HeraDCOBank.h"
 #include "Engine/HeraVCF.h"
 #include "Engine/HeraHPF.hxx"
 #include "Engine/HeraVCA.hxx"
@@ -67,46 +93,30 @@ typedef plugin_api_v2_t* (*move_plugin_init_v2_fn)(const host_api_v1_t *host);
 #include "Engine/SmoothValue.h"
 #include "Engine/HeraTables.h"
 #include "Engine/FaustHelpers.h"
+#include "Engine/FastExp2.h"
+#include "Engine/ControlRate.h"
 #include "param_helper.h"
+#include "hera_presets.h"
+#include "render_pool.h"
+#include "spsc_queue.h"
 
 /* =====================================================================
  * Constants
  * ===================================================================== */
 
-#define MAX_VOICES 6
-#define MAX_PRESETS 128
+#define MAX_VOICES 16        /* Voice pool size, upper bound for polyphony */
+#define DEFAULT_VOICES 6
+#define VOICE_MIX_GAIN (1.0f / DEFAULT_VOICES)  /* Per-voice headroom, independent of polyphony */
+#define DEFAULT_CPU_LIMIT 0.8f  /* Fraction of the block deadline before voices are shed */
+#define DEFAULT_SILENCE_FLOOR_DB -80.0f
+#define SILENT_SAMPLES_TO_RETIRE 2048  /* ~46 ms, longer than a period of the lowest notes */
+#define MAX_MIDI_EVENTS 256
+#define MIDI_INBOX_SIZE 256     /* MIDI from on_midi/on_midi_batch awaiting render_block */
+#define CONTROL_QUEUE_SIZE 64   /* set_param changes awaiting render_block */
+#define MAX_CONTROL_INTERVAL 32  /* Samples between control-rate modulation points */
+#define VOICE_GROUPS ((MAX_VOICES + kSimdLanes - 1) / kSimdLanes)  /* Units of parallel voice work */
 #define MAX_BLOCK_SIZE 256
-
-/* Hera parameter indices (matching original Hera) */
-enum {
-    kHeraParamVCA,
-    kHeraParamVCAType,
-    kHeraParamPWMDepth,
-    kHeraParamPWMMod,
-    kHeraParamSawLevel,
-    kHeraParamPulseLevel,
-    kHeraParamSubLevel,
-    kHeraParamNoiseLevel,
-    kHeraParamPitchRange,
-    kHeraParamPitchModDepth,
-    kHeraParamVCFCutoff,
-    kHeraParamVCFResonance,
-    kHeraParamVCFEnvelopeModDepth,
-    kHeraParamVCFLFOModDepth,
-    kHeraParamVCFKeyboardModDepth,
-    kHeraParamVCFBendDepth,
-    kHeraParamAttack,
-    kHeraParamDecay,
-    kHeraParamSustain,
-    kHeraParamRelease,
-    kHeraParamLFOTriggerMode,
-    kHeraParamLFORate,
-    kHeraParamLFODelay,
-    kHeraParamHPF,
-    kHeraParamChorusI,
-    kHeraParamChorusII,
-    kHeraNumParameters,
-};
+#define CACHE_LINE_SIZE 64
 
 enum { kHeraVCATypeEnvelope, kHeraVCATypeGate };
 enum { kHeraPWMManual, kHeraPWMLFO, kHeraPWMEnvelope };
@@ -137,10 +147,9 @@ struct HeraVoiceState {
     float frequency;        /* Hz */
     float velocity;         /* 0-1 */
     float pitchBendFactor;  /* frequency multiplier from pitch bend */
+    int silentSamples;      /* consecutive released samples below the silence floor */
 
-    /* Per-voice DSP */
-    HeraDCO dco;
-    HeraVCF vcf;
+    /* Per-voice DSP (DCO and VCF live in hera_instance_t's SIMD banks) */
     HeraEnvelope normalEnvelope;
     HeraEnvelope gateEnvelope;
     OnePoleSmoothValue smoothPWMDepth;
@@ -150,29 +159,13 @@ struct HeraVoiceState {
     int pwmMod;
 
     HeraVoiceState() : active(false), note(-1), frequency(440.0f),
-                       velocity(0.0f), pitchBendFactor(1.0f),
+                       velocity(0.0f), pitchBendFactor(1.0f), silentSamples(0),
                        vcaType(kHeraVCATypeEnvelope), pwmMod(kHeraPWMManual) {
-        normalEnvelope.setSampleRate(MOVE_SAMPLE_RATE);
-        gateEnvelope.setSampleRate(MOVE_SAMPLE_RATE);
-        dco.init(MOVE_SAMPLE_RATE);
-
-        /* Gate envelope: fast attack/release for gate mode */
-        gateEnvelope.setAttack(0.00247f);
-        gateEnvelope.setDecay(0.0057f);
-        gateEnvelope.setSustain(0.98f);
-        gateEnvelope.setRelease(0.0057f);
-
         smoothPWMDepth.setTimeConstant(10e-3f);
         smoothPWMDepth.setSampleRate(MOVE_SAMPLE_RATE);
     }
 
     void setSampleRate(float rate) {
-        normalEnvelope.setSampleRate(rate);
-        gateEnvelope.setSampleRate(rate);
-        dco.classInit(rate);
-        dco.instanceConstants(rate);
-        dco.instanceClear();
-        vcf.setSampleRate(rate);
         smoothPWMDepth.setSampleRate(rate);
     }
 
@@ -187,79 +180,64 @@ struct HeraVoiceState {
 };
 
 /* =====================================================================
- * Preset structure
+ * Preset bank
  * ===================================================================== */
 
-struct HeraPreset {
-    char name[64];
-    float values[kHeraNumParameters];
+#define USER_PRESETS_DIR "user"  /* Subdirectory of presets/ scanned for user banks */
+
+/* Parameters whose engine state takes real math to derive: envelope
+   coefficients and the LFO curves. A preset carries them precompiled. */
+static constexpr uint32_t kHeraCompiledParams =
+    (1u << kHeraParamAttack) | (1u << kHeraParamDecay) | (1u << kHeraParamSustain) |
+    (1u << kHeraParamRelease) | (1u << kHeraParamLFORate) | (1u << kHeraParamLFODelay);
+
+/* Engine state for a preset's kHeraCompiledParams, copied in on a switch */
+struct HeraPresetEngine {
+    HeraEnvelopeShape envelopeShape;
+    EnvelopeShape lfoEnvelopeShape;
+    float lfoFrequency;
 };
 
-/* =====================================================================
- * Parameter IDs (strings used in XML presets)
- * ===================================================================== */
+/* One preset of a bank. Presets are parsed (if XML) and compiled on first
+   use or by the background loader, and are read-only once `ready` is set. */
+struct HeraPresetEntry {
+    char file[256];   /* Path under <module_dir>/presets, empty if from presets.bin */
+    HeraPreset preset;
+    HeraPresetEngine engine;
+    std::atomic<bool> ready{false};
+};
 
-static const char* g_param_ids[kHeraNumParameters] = {
-    "VCADepth",          /* kHeraParamVCA */
-    "VCAType",           /* kHeraParamVCAType */
-    "DCOPWMDepth",       /* kHeraParamPWMDepth */
-    "DCOPWMMod",         /* kHeraParamPWMMod */
-    "DCOSawLevel",       /* kHeraParamSawLevel */
-    "DCOPulseLevel",     /* kHeraParamPulseLevel */
-    "DCOSubLevel",       /* kHeraParamSubLevel */
-    "DCONoiseLevel",     /* kHeraParamNoiseLevel */
-    "DCORange",          /* kHeraParamPitchRange */
-    "DCOPitchModDepth",  /* kHeraParamPitchModDepth */
-    "VCFCutoff",         /* kHeraParamVCFCutoff */
-    "VCFResonance",      /* kHeraParamVCFResonance */
-    "VCFEnv",            /* kHeraParamVCFEnvelopeModDepth */
-    "VCFLFO",            /* kHeraParamVCFLFOModDepth */
-    "VCFKey",            /* kHeraParamVCFKeyboardModDepth */
-    "VCFBendDepth",      /* kHeraParamVCFBendDepth */
-    "ENVAttack",         /* kHeraParamAttack */
-    "ENVDecay",          /* kHeraParamDecay */
-    "ENVSustain",        /* kHeraParamSustain */
-    "ENVRelease",        /* kHeraParamRelease */
-    "LFOTrigMode",       /* kHeraParamLFOTriggerMode */
-    "LFORate",           /* kHeraParamLFORate */
-    "LFODelay",          /* kHeraParamLFODelay */
-    "HPF",               /* kHeraParamHPF */
-    "ChorusI",           /* kHeraParamChorusI */
-    "ChorusII",          /* kHeraParamChorusII */
+/* Modification times of what a bank was indexed from */
+struct HeraPresetStamp {
+    struct timespec bin, presets, user;
 };
 
-/* Default parameter values */
-static const float g_param_defaults[kHeraNumParameters] = {
-    0.5f,   /* VCA depth */
-    0.0f,   /* VCA type (envelope) */
-    0.5f,   /* PWM depth */
-    0.0f,   /* PWM mod (manual) */
-    1.0f,   /* Saw level */
-    0.0f,   /* Pulse level */
-    0.0f,   /* Sub level */
-    0.0f,   /* Noise level */
-    1.0f,   /* Pitch range (8') */
-    0.0f,   /* Pitch mod depth */
-    0.5f,   /* VCF cutoff */
-    0.0f,   /* VCF resonance */
-    0.0f,   /* VCF envelope mod depth */
-    0.0f,   /* VCF LFO mod depth */
-    0.0f,   /* VCF keyboard mod depth */
-    0.0f,   /* VCF bend depth */
-    0.0f,   /* Attack */
-    0.0f,   /* Decay */
-    0.0f,   /* Sustain */
-    0.0f,   /* Release */
-    1.0f,   /* LFO trigger mode (auto) */
-    0.0f,   /* LFO rate */
-    0.0f,   /* LFO delay */
-    0.0f,   /* HPF */
-    0.0f,   /* Chorus I */
-    0.0f,   /* Chorus II */
+/* Presets from one module directory, shared by every instance created
+   from it and freed with the last of them. The index is fixed once the
+   bank is built; a bank whose stamp no longer matches the disk is marked
+   stale and only kept for the instances already using it. */
+struct HeraPresetBank {
+    char module_dir[256];
+    HeraPresetStamp stamp = {};
+    bool stale = false;
+    int refcount = 0;
+    int count = 0;
+    HeraPresetEntry *entries = NULL;
+    std::mutex parseLock;       /* Serialises parsing between loader and callers */
+    std::thread loader;
+    bool loaderStarted = false;  /* Guarded by g_preset_banks_lock */
+    std::atomic<bool> cancelLoader{false};
+    HeraPresetBank *next = NULL;
+
+    ~HeraPresetBank() { delete[] entries; }
 };
 
+/* =====================================================================
+ * Shadow UI parameters
+ * ===================================================================== */
+
 /* Shadow UI parameter definitions for the param_helper */
-static const param_def_t g_shadow_params[] = {
+static constexpr param_def_t g_shadow_params[] = {
     /* DCO */
     {"saw_level",    "Saw Level",    PARAM_TYPE_FLOAT, kHeraParamSawLevel,    0.0f, 1.0f},
     {"pulse_level",  "Pulse Level",  PARAM_TYPE_FLOAT, kHeraParamPulseLevel,  0.0f, 1.0f},
@@ -301,21 +279,163 @@ static const param_def_t g_shadow_params[] = {
     {"chorus_ii",    "Chorus II",    PARAM_TYPE_INT,   kHeraParamChorusII,    0.0f, 1.0f},
 };
 
+static constexpr auto g_shadow_lookup = makeKeyLookup<64>(g_shadow_params, &param_def_t::key);
+
+/* Keys handled by the plugin itself rather than through g_shadow_params */
+enum {
+    kKeyState,
+    kKeyPreset,
+    kKeyPresetCount,
+    kKeyPresetName,
+    kKeyName,
+    kKeyVolume,
+    kKeyOctaveTranspose,
+    kKeyPolyphony,
+    kKeyCpuLimit,
+    kKeySilenceFloor,
+    kKeyControlInterval,
+    kKeyRenderThreads,
+    kKeyCpuLoad,
+    kKeyLimiterInterventions,
+    kKeyAllNotesOff,
+    kKeyUiHierarchy,
+    kKeyChainParams,
+    kKeyParams,
+    kKeyStateBin,
+    kKeyControlOverflows,
+    kKeyMidiOverflows,
+    kNumPluginKeys
+};
+
+static constexpr const char* g_plugin_keys[kNumPluginKeys] = {
+    "state",
+    "preset",
+    "preset_count",
+    "preset_name",
+    "name",
+    "volume",
+    "octave_transpose",
+    "polyphony",
+    "cpu_limit",
+    "silence_floor",
+    "control_interval",
+    "render_threads",
+    "cpu_load",
+    "limiter_interventions",
+    "all_notes_off",
+    "ui_hierarchy",
+    "chain_params",
+    "params",
+    "state_bin",
+    "control_overflows",
+    "midi_overflows",
+};
+
+static constexpr auto g_plugin_key_lookup = makeKeyLookup<64>(g_plugin_keys);
+
+/* =====================================================================
+ * Control events
+ *
+ * set_param may run on any one host thread while render_block runs on the
+ * audio thread. set_param records each change in the instance's
+ * HeraControlState, which is what get_param reports, and queues it as a
+ * HeraControlEvent; render_block drains the queue before rendering, so
+ * the engine is only ever touched from the audio thread.
+ *
+ * MIDI has its own queue, since it may come from another thread. Every
+ * event in either queue takes a number from one per-instance sequence,
+ * and render_block merges the two queues by it, so the engine sees
+ * set_param and MIDI in the order the host sent them.
+ * ===================================================================== */
+
+enum {
+    kControlParams,             /* Apply values[] for the parameters in mask */
+    kControlPreset,             /* All notes off, then as kControlParams with engine */
+    kControlVolume,
+    kControlOctaveTranspose,
+    kControlPolyphony,
+    kControlCpuLimit,
+    kControlSilenceFloor,
+    kControlControlInterval,
+    kControlAllNotesOff,
+};
+
+struct HeraControlEvent {
+    uint32_t seq;       /* Position among all host events, see above */
+    int type;
+    float value;        /* Scalar settings */
+    uint32_t mask;      /* kControlParams, kControlPreset */
+    float values[kHeraNumParameters];
+    const HeraPresetEngine *engine;  /* kControlPreset, owned by the bank */
+};
+
+static_assert(kHeraNumParameters <= 32, "HeraControlEvent::mask holds one bit per parameter");
+
+/* Settings as last set, ahead of the engine until the queue drains */
+struct HeraControlState {
+    float params[kHeraNumParameters];
+    float volume;
+    int octave_transpose;
+    int polyphony;
+    float cpuLimit;
+    float silenceFloorDb;
+    int controlInterval;
+    bool resync;        /* An event was dropped: resend everything */
+    bool notesOffPending;   /* A dropped event cut all notes: replay it */
+    uint32_t notesOffSeq;   /* ...at the dropped event's place in the order */
+};
+
+/* MIDI from on_midi (immediate) or on_midi_batch (timed, at ev.frame) */
+struct HeraMidiEvent {
+    uint32_t seq;
+    bool timed;
+    move_midi_event_t ev;
+};
+
 /* =====================================================================
  * Instance structure
  * ===================================================================== */
 
 typedef struct {
-    char module_dir[256];
+    /* ---------------------------------------------------------------
+     * Render state: everything render_block touches, kept together at
+     * the start of the instance with each group on its own cache line
+     * --------------------------------------------------------------- */
 
-    /* Parameters */
-    float params[kHeraNumParameters];
+    /* Shared buffers for rendering */
+    alignas(CACHE_LINE_SIZE) float lfoBuffer[MAX_BLOCK_SIZE];
+    float detuneBuffer[MAX_BLOCK_SIZE];
+    float cutoffOctavesBuffer[MAX_BLOCK_SIZE];
+    float resonanceBuffer[MAX_BLOCK_SIZE];
+    float vcfEnvModBuffer[MAX_BLOCK_SIZE];
+    float vcfLFODetuneOctavesBuffer[MAX_BLOCK_SIZE];
+    float vcfKeyboardModBuffer[MAX_BLOCK_SIZE];
+    float vcfBendDepthBuffer[MAX_BLOCK_SIZE];
+    float mixBuffer[MAX_BLOCK_SIZE];
+    float chorusOutL[MAX_BLOCK_SIZE];
+    float chorusOutR[MAX_BLOCK_SIZE];
 
-    /* Voices */
-    HeraVoiceState voices[MAX_VOICES];
+    /* Per-group mixes, summed in group order once all groups are done */
+    alignas(CACHE_LINE_SIZE) float groupMix[VOICE_GROUPS][MAX_BLOCK_SIZE];
+
+    /* Per-voice buffers, alive across the DCO and VCF bank passes */
+    alignas(CACHE_LINE_SIZE) float envelopeBuffer[MAX_VOICES][MAX_BLOCK_SIZE];
+    float gateBuffer[MAX_VOICES][MAX_BLOCK_SIZE];
+    float pwmModBuffer[MAX_VOICES][MAX_BLOCK_SIZE];
+    float cutoffBuffer[MAX_VOICES][MAX_BLOCK_SIZE];
+    float dcoBuffer[MAX_VOICES][MAX_BLOCK_SIZE];
+
+    /* Voices: a preallocated pool, of which the first `polyphony` are used */
+    alignas(CACHE_LINE_SIZE) HeraVoiceState voices[MAX_VOICES];
+    int polyphony;
+    int voiceLimit;         /* <= polyphony, lowered by the CPU limiter */
+    HeraEnvelopeShape envelopeShape;      /* ADSR coefficients, shared by all voices */
+    HeraEnvelopeShape gateEnvelopeShape;  /* Fixed fast envelope for gate mode */
+    alignas(CACHE_LINE_SIZE) HeraDCOBank<MAX_VOICES, MAX_BLOCK_SIZE> dcoBank;
+    alignas(CACHE_LINE_SIZE) HeraVCFBank<MAX_VOICES, MAX_BLOCK_SIZE> vcfBank;
 
     /* Shared synth state */
-    HeraLFOWithEnvelope lfo;
+    alignas(CACHE_LINE_SIZE) HeraLFOWithEnvelope lfo;
     HeraHPF hpFilter;
     HeraVCA vca;
     HeraChorus chorus;
@@ -326,41 +446,53 @@ typedef struct {
     OnePoleSmoothValue smoothVCFLFOModDepth;
     OnePoleSmoothValue smoothVCFKeyboardModDepth;
     OnePoleSmoothValue smoothVCFBendDepth;
+    float params[kHeraNumParameters];
     float pitchFactor;
+    float pitchBendSemitones;
+    int controlInterval;    /* 1 = modulation computed at audio rate */
     int vcaType;
     int lfoMode;
+    int octave_transpose;
+    float output_gain;
+    float volume;   /* User-controllable volume 0-1, default 0.8 */
+    bool groupActive[VOICE_GROUPS];
+    int groupFrames;
 
-    /* Shared buffers for rendering */
-    float lfoBuffer[MAX_BLOCK_SIZE];
-    float detuneBuffer[MAX_BLOCK_SIZE];
-    float dcoBuffer[MAX_BLOCK_SIZE];
-    float envelopeBuffer[MAX_BLOCK_SIZE];
-    float gateBuffer[MAX_BLOCK_SIZE];
-    float pwmModBuffer[MAX_BLOCK_SIZE];
-    float cutoffOctavesBuffer[MAX_BLOCK_SIZE];
-    float cutoffBuffer[MAX_BLOCK_SIZE];
-    float resonanceBuffer[MAX_BLOCK_SIZE];
-    float vcfEnvModBuffer[MAX_BLOCK_SIZE];
-    float vcfLFODetuneOctavesBuffer[MAX_BLOCK_SIZE];
-    float vcfKeyboardModBuffer[MAX_BLOCK_SIZE];
-    float vcfBendDepthBuffer[MAX_BLOCK_SIZE];
-    float mixBuffer[MAX_BLOCK_SIZE];
-    float chorusOutL[MAX_BLOCK_SIZE];
-    float chorusOutR[MAX_BLOCK_SIZE];
+    /* CPU limiter state */
+    float cpuLimit;         /* 0 disables the limiter */
+    std::atomic<float> cpuLoad;  /* Render time / block deadline, peak-held */
+    std::atomic<uint32_t> limiterInterventions;
 
-    /* Pitch bend state */
-    float pitchBendSemitones;
+    /* Early retirement of inaudible voices */
+    float silenceFloorDb;
+    float silenceThreshold; /* silenceFloorDb as linear peak amplitude */
+
+    /* Optional worker threads sharing the voice groups, 0 = audio thread only */
+    RenderPool renderPool;
+    int renderThreads;
+
+    /* Changes from set_param and MIDI from the host, drained by render_block */
+    SpscQueue<HeraControlEvent, CONTROL_QUEUE_SIZE> controlQueue;
+    SpscQueue<HeraMidiEvent, MIDI_INBOX_SIZE> midiInbox;
+    std::atomic<uint32_t> hostEventSeq;
+
+    /* Timestamped MIDI waiting for the next render_block, sorted by frame */
+    int midiQueueCount;
+    move_midi_event_t midiQueue[MAX_MIDI_EVENTS];
+
+    /* ---------------------------------------------------------------
+     * Control state: parameters, presets and paths, only touched from
+     * set_param/get_param and preset changes
+     * --------------------------------------------------------------- */
+
+    /* Settings reported by get_param */
+    alignas(CACHE_LINE_SIZE) HeraControlState control;
 
     /* Preset state */
-    HeraPreset presets[MAX_PRESETS];
-    int preset_count;
     int current_preset;
     char preset_name[64];
-
-    /* UI state */
-    int octave_transpose;
-    float output_gain;
-    float volume;   /* User-controllable volume 0-1, default 0.8 */
+    char module_dir[256];
+    HeraPresetBank *presetBank;
 } hera_instance_t;
 
 /* =====================================================================
@@ -368,7 +500,7 @@ typedef struct {
  * ===================================================================== */
 
 static float midi_to_freq(int note) {
-    return 440.0f * powf(2.0f, (note - 69) / 12.0f);
+    return 440.0f * fastExp2((note - 69) / 12.0f);
 }
 
 /* =====================================================================
@@ -386,32 +518,28 @@ static void apply_param(hera_instance_t *inst, int param_idx, float value) {
         break;
     case kHeraParamVCAType:
         inst->vcaType = (int)value;
-        for (int i = 0; i < MAX_VOICES; i++)
+        for (int i = 0; i < inst->polyphony; i++)
             inst->voices[i].vcaType = inst->vcaType;
         break;
     case kHeraParamPWMDepth:
-        for (int i = 0; i < MAX_VOICES; i++)
+        for (int i = 0; i < inst->polyphony; i++)
             inst->voices[i].smoothPWMDepth.setTargetValue(value);
         break;
     case kHeraParamPWMMod:
-        for (int i = 0; i < MAX_VOICES; i++)
+        for (int i = 0; i < inst->polyphony; i++)
             inst->voices[i].pwmMod = (int)value;
         break;
     case kHeraParamSawLevel:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].dco.setSawLevel(value);
+        inst->dcoBank.setSawLevel(value);
         break;
     case kHeraParamPulseLevel:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].dco.setPulseLevel(value);
+        inst->dcoBank.setPulseLevel(value);
         break;
     case kHeraParamSubLevel:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].dco.setSubLevel(value);
+        inst->dcoBank.setSubLevel(value);
         break;
     case kHeraParamNoiseLevel:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].dco.setNoiseLevel(value);
+        inst->dcoBank.setNoiseLevel(value);
         break;
     case kHeraParamPitchRange: {
         const float factors[] = { 0.5f, 1.0f, 2.0f };
@@ -441,20 +569,16 @@ static void apply_param(hera_instance_t *inst, int param_idx, float value) {
         inst->smoothVCFBendDepth.setTargetValue(value);
         break;
     case kHeraParamAttack:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].normalEnvelope.setAttack(value);
+        inst->envelopeShape.setAttack(value);
         break;
     case kHeraParamDecay:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].normalEnvelope.setDecay(value);
+        inst->envelopeShape.setDecay(value);
         break;
     case kHeraParamSustain:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].normalEnvelope.setSustain(value);
+        inst->envelopeShape.setSustain(value);
         break;
     case kHeraParamRelease:
-        for (int i = 0; i < MAX_VOICES; i++)
-            inst->voices[i].normalEnvelope.setRelease(value);
+        inst->envelopeShape.setRelease(value);
         break;
     case kHeraParamLFOTriggerMode: {
         int newMode = (int)value;
@@ -484,143 +608,332 @@ static void apply_param(hera_instance_t *inst, int param_idx, float value) {
 }
 
 /* =====================================================================
- * Preset loading from XML files
+ * Preset loading
  * ===================================================================== */
 
-/* Simple XML attribute parser */
-static const char* find_xml_attr(const char *xml, const char *attr_name, char *buf, int buf_len) {
-    char search[64];
-    snprintf(search, sizeof(search), "%s=\"", attr_name);
-    const char *pos = strstr(xml, search);
-    if (!pos) return NULL;
+static void read_preset_stamp(const char *module_dir, HeraPresetStamp *stamp) {
+    const char *paths[3] = { "presets.bin", "presets", "presets/" USER_PRESETS_DIR };
+    struct timespec *times[3] = { &stamp->bin, &stamp->presets, &stamp->user };
 
-    pos += strlen(search);
-    const char *end = strchr(pos, '"');
-    if (!end) return NULL;
-
-    int len = end - pos;
-    if (len >= buf_len) len = buf_len - 1;
-    strncpy(buf, pos, len);
-    buf[len] = '\0';
-    return end + 1;
-}
-
-static int load_preset_xml(hera_instance_t *inst, const char *path, int preset_idx) {
-    if (preset_idx >= MAX_PRESETS) return -1;
-
-    FILE *f = fopen(path, "rb");
-    if (!f) return -1;
-
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
-
-    if (size <= 0 || size > 65536) { fclose(f); return -1; }
-
-    char *data = (char*)malloc(size + 1);
-    if (!data) { fclose(f); return -1; }
-    fread(data, 1, size, f);
-    data[size] = '\0';
-    fclose(f);
-
-    HeraPreset *p = &inst->presets[preset_idx];
-    memset(p, 0, sizeof(HeraPreset));
-
-    /* Set defaults */
-    for (int i = 0; i < kHeraNumParameters; i++)
-        p->values[i] = g_param_defaults[i];
-
-    /* Extract preset name from <PROGRAM name="..."/> */
-    char name_buf[64];
-    if (find_xml_attr(data, "name", name_buf, sizeof(name_buf))) {
-        strncpy(p->name, name_buf, sizeof(p->name) - 1);
-    } else {
-        snprintf(p->name, sizeof(p->name), "Preset %d", preset_idx);
-    }
-
-    /* Extract parameter values from <PARAM id="..." value="..."/> */
-    const char *pos = data;
-    while ((pos = strstr(pos, "<PARAM ")) != NULL) {
-        char id_buf[64], val_buf[32];
-        if (find_xml_attr(pos, "id", id_buf, sizeof(id_buf)) &&
-            find_xml_attr(pos, "value", val_buf, sizeof(val_buf))) {
-
-            float val = atof(val_buf);
-            /* Find matching parameter */
-            for (int i = 0; i < kHeraNumParameters; i++) {
-                if (strcmp(id_buf, g_param_ids[i]) == 0) {
-                    p->values[i] = val;
-                    break;
-                }
-            }
+    for (int i = 0; i < 3; i++) {
+        char path[300];
+        snprintf(path, sizeof(path), "%s/%s", module_dir, paths[i]);
+        struct stat st;
+        if (stat(path, &st) == 0) {
+            *times[i] = st.st_mtim;
+        } else {
+            times[i]->tv_sec = 0;
+            times[i]->tv_nsec = 0;
         }
-        pos++;
     }
+}
 
-    free(data);
-    return 0;
+static bool same_preset_stamp(const HeraPresetStamp *a, const HeraPresetStamp *b) {
+    const struct timespec *ta[3] = { &a->bin, &a->presets, &a->user };
+    const struct timespec *tb[3] = { &b->bin, &b->presets, &b->user };
+    for (int i = 0; i < 3; i++) {
+        if (ta[i]->tv_sec != tb[i]->tv_sec || ta[i]->tv_nsec != tb[i]->tv_nsec)
+            return false;
+    }
+    return true;
 }
 
-static int load_presets(hera_instance_t *inst) {
-    char presets_dir[512];
-    snprintf(presets_dir, sizeof(presets_dir), "%s/presets", inst->module_dir);
+/* Read the compiled bank shipped next to dsp.so with a single read.
+   Returns malloc'd records, or NULL if it is missing or was built for a
+   different parameter list. */
+static HeraPreset *read_preset_bin(const char *module_dir, int *count) {
+    char path[300];
+    snprintf(path, sizeof(path), "%s/presets.bin", module_dir);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
 
-    inst->preset_count = 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(HeraBankHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    char *data = (char*)malloc(size);
+    ssize_t got = data ? read(fd, data, size) : -1;
+    close(fd);
+    if (got != (ssize_t)size) {
+        free(data);
+        return NULL;
+    }
+
+    HeraBankHeader header;
+    memcpy(&header, data, sizeof(header));
+    *count = hera_bank_header_check(&header);
+    if (*count < 0 || size != sizeof(header) + (size_t)*count * sizeof(HeraPreset)) {
+        free(data);
+        plugin_log("presets.bin does not match this build, using XML presets");
+        return NULL;
+    }
+
+    /* Return the records in place, at the start of the buffer */
+    memmove(data, data + sizeof(header), size - sizeof(header));
+    return (HeraPreset*)data;
+}
 
-    /* Load presets in order: Preset000.xml, Preset001.xml, ... */
-    for (int i = 0; i < MAX_PRESETS; i++) {
-        char path[600];
-        snprintf(path, sizeof(path), "%s/Preset%03d.xml", presets_dir, i);
+/* Append the .xml files in dir to files, sorted, each prefixed with prefix */
+static void scan_preset_dir(const char *dir, const char *prefix, std::vector<std::string> &files) {
+    DIR *d = opendir(dir);
+    if (!d) return;
+
+    size_t first = files.size();
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        if (ent->d_type != DT_REG && ent->d_type != DT_LNK && ent->d_type != DT_UNKNOWN)
+            continue;
+        size_t len = strlen(ent->d_name);
+        if (len < 5 || strcasecmp(ent->d_name + len - 4, ".xml") != 0)
+            continue;
+        if (strlen(prefix) + len >= sizeof(HeraPresetEntry::file))
+            continue;
+        files.push_back(std::string(prefix) + ent->d_name);
+    }
+    closedir(d);
 
-        FILE *test = fopen(path, "r");
-        if (!test) break;
-        fclose(test);
+    std::sort(files.begin() + first, files.end());
+}
 
-        if (load_preset_xml(inst, path, inst->preset_count) == 0) {
-            inst->preset_count++;
+/* Index a bank: factory presets from presets.bin or, failing that, the
+   XML files in presets/, followed by any XML files in presets/user/. The
+   binary bank is read whole; XML presets are parsed as they are needed. */
+static int index_presets(HeraPresetBank *bank) {
+    read_preset_stamp(bank->module_dir, &bank->stamp);
+
+    char presets_dir[300];
+    snprintf(presets_dir, sizeof(presets_dir), "%s/presets", bank->module_dir);
+    char user_dir[320];
+    snprintf(user_dir, sizeof(user_dir), "%s/" USER_PRESETS_DIR, presets_dir);
+
+    int binCount = 0;
+    HeraPreset *bin = read_preset_bin(bank->module_dir, &binCount);
+
+    std::vector<std::string> files;
+    if (!bin)
+        scan_preset_dir(presets_dir, "", files);
+    scan_preset_dir(user_dir, USER_PRESETS_DIR "/", files);
+
+    bank->count = 0;
+    bank->entries = new (std::nothrow) HeraPresetEntry[binCount + files.size()];
+    if (bank->entries) {
+        for (int i = 0; i < binCount; i++) {
+            HeraPresetEntry &entry = bank->entries[bank->count++];
+            entry.file[0] = '\0';
+            entry.preset = bin[i];
+            entry.preset.name[sizeof(entry.preset.name) - 1] = '\0';
+        }
+        for (size_t i = 0; i < files.size(); i++) {
+            HeraPresetEntry &entry = bank->entries[bank->count++];
+            snprintf(entry.file, sizeof(entry.file), "%s", files[i].c_str());
         }
     }
+    free(bin);
 
     char msg[128];
-    snprintf(msg, sizeof(msg), "Loaded %d presets", inst->preset_count);
+    snprintf(msg, sizeof(msg), "Indexed %d presets (%d from presets.bin, %d XML)",
+             bank->count, binCount, (int)files.size());
     plugin_log(msg);
 
-    return inst->preset_count;
+    return bank->count;
 }
 
-static void apply_preset(hera_instance_t *inst, int preset_idx) {
-    if (preset_idx < 0 || preset_idx >= inst->preset_count) return;
+/* Do the work apply_param would do for the preset's kHeraCompiledParams */
+static void compile_preset(const HeraPreset &p, HeraPresetEngine *engine) {
+    engine->envelopeShape.setSampleRate(MOVE_SAMPLE_RATE);
+    engine->envelopeShape.setAttack(p.values[kHeraParamAttack]);
+    engine->envelopeShape.setDecay(p.values[kHeraParamDecay]);
+    engine->envelopeShape.setSustain(p.values[kHeraParamSustain]);
+    engine->envelopeShape.setRelease(p.values[kHeraParamRelease]);
 
-    HeraPreset *p = &inst->presets[preset_idx];
-    inst->current_preset = preset_idx;
-    snprintf(inst->preset_name, sizeof(inst->preset_name), "%s", p->name);
+    HeraLFOWithEnvelope lfo;
+    lfo.setSampleRate(MOVE_SAMPLE_RATE);
+    lfo.setDelayDuration(curveFromLfoDelaySliderToDelay(p.values[kHeraParamLFODelay]));
+    lfo.setAttackDuration(curveFromLfoDelaySliderToAttack(p.values[kHeraParamLFODelay]));
+    engine->lfoEnvelopeShape = lfo.getEnvelopeShape();
+    engine->lfoFrequency = curveFromLfoRateSliderToFreq(p.values[kHeraParamLFORate]);
+}
 
-    for (int i = 0; i < kHeraNumParameters; i++) {
-        apply_param(inst, i, p->values[i]);
+/* Return entry idx, parsing and compiling it now if nothing has yet. An
+   unreadable file gives a preset with default values. */
+static const HeraPresetEntry *get_preset_entry(HeraPresetBank *bank, int idx) {
+    HeraPresetEntry &entry = bank->entries[idx];
+    if (entry.ready.load(std::memory_order_acquire))
+        return &entry;
+
+    std::lock_guard<std::mutex> lock(bank->parseLock);
+    if (!entry.ready.load(std::memory_order_relaxed)) {
+        if (entry.file[0]) {
+            char path[600];
+            snprintf(path, sizeof(path), "%s/presets/%s", bank->module_dir, entry.file);
+            bool exists;
+            char *data = read_preset_file(path, &exists);
+            parse_preset_xml(data ? data : "", &entry.preset, idx);
+            free(data);
+        }
+        compile_preset(entry.preset, &entry.engine);
+        entry.ready.store(true, std::memory_order_release);
+    }
+    return &entry;
+}
+
+/* Background thread: prepare the presets no one has asked for yet, at idle
+   priority so it never competes with audio or UI work */
+static void preset_loader_main(HeraPresetBank *bank) {
+    struct sched_param param = {};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+    for (int i = 0; i < bank->count; i++) {
+        if (bank->cancelLoader.load(std::memory_order_relaxed)) return;
+        get_preset_entry(bank, i);
     }
 }
 
+/* =====================================================================
+ * Shared preset banks
+ * ===================================================================== */
+
+static std::mutex g_preset_banks_lock;
+static HeraPresetBank *g_preset_banks = NULL;
+
+/* Return the bank for module_dir, indexing it on first use or when the
+   preset directories have changed since it was indexed */
+static HeraPresetBank *acquire_preset_bank(const char *module_dir) {
+    std::lock_guard<std::mutex> lock(g_preset_banks_lock);
+
+    HeraPresetStamp stamp;
+    read_preset_stamp(module_dir, &stamp);
+    for (HeraPresetBank *bank = g_preset_banks; bank; bank = bank->next) {
+        if (bank->stale || strcmp(bank->module_dir, module_dir) != 0) continue;
+        if (same_preset_stamp(&bank->stamp, &stamp)) {
+            bank->refcount++;
+            return bank;
+        }
+        bank->stale = true;
+        plugin_log("Presets changed on disk, reindexing");
+    }
+
+    HeraPresetBank *bank = new (std::nothrow) HeraPresetBank();
+    if (!bank) return NULL;
+    snprintf(bank->module_dir, sizeof(bank->module_dir), "%s", module_dir);
+    index_presets(bank);
+    bank->refcount = 1;
+    bank->next = g_preset_banks;
+    g_preset_banks = bank;
+    return bank;
+}
+
+static void release_preset_bank(HeraPresetBank *bank) {
+    if (!bank) return;
+    std::lock_guard<std::mutex> lock(g_preset_banks_lock);
+
+    if (--bank->refcount > 0) return;
+    for (HeraPresetBank **link = &g_preset_banks; *link; link = &(*link)->next) {
+        if (*link == bank) {
+            *link = bank->next;
+            break;
+        }
+    }
+    if (bank->loader.joinable()) {
+        bank->cancelLoader.store(true);
+        bank->loader.join();
+    }
+    delete bank;
+}
+
+/* Start the loader once the creating instance has what it needs, so the
+   two do not contend for the first preset */
+static void start_preset_loader(HeraPresetBank *bank) {
+    std::lock_guard<std::mutex> lock(g_preset_banks_lock);
+    if (bank->loaderStarted) return;
+    bank->loaderStarted = true;
+
+    for (int i = 0; i < bank->count; i++) {
+        if (!bank->entries[i].ready.load(std::memory_order_acquire)) {
+            bank->loader = std::thread(preset_loader_main, bank);
+            return;
+        }
+    }
+}
+
+static int preset_count(const hera_instance_t *inst) {
+    return inst->presetBank ? inst->presetBank->count : 0;
+}
+
+/* Make preset_idx current and return it, without applying its values */
+static const HeraPresetEntry *select_preset(hera_instance_t *inst, int preset_idx) {
+    const HeraPresetEntry *entry = get_preset_entry(inst->presetBank, preset_idx);
+    inst->current_preset = preset_idx;
+    snprintf(inst->preset_name, sizeof(inst->preset_name), "%s", entry->preset.name);
+    return entry;
+}
+
 /* =====================================================================
  * Voice management
  * ===================================================================== */
 
 static bool has_unreleased_voices(hera_instance_t *inst) {
-    for (int i = 0; i < MAX_VOICES; i++) {
+    for (int i = 0; i < inst->polyphony; i++) {
         if (inst->voices[i].active && !inst->voices[i].isReleased())
             return true;
     }
     return false;
 }
 
+static int count_active_voices(hera_instance_t *inst) {
+    int count = 0;
+    for (int i = 0; i < inst->polyphony; i++) {
+        if (inst->voices[i].active) count++;
+    }
+    return count;
+}
+
+/* Loudness estimate of a voice, for the CPU limiter */
+static float voice_level(HeraVoiceState &voice) {
+    return voice.velocity * voice.velocity * voice.getCurrentEnvelope().getCurrentValue();
+}
+
+/* Quietest active voice that is in release (or still held), or -1 */
+static int find_quietest_voice(hera_instance_t *inst, bool released) {
+    int best = -1;
+    float bestLevel = 0.0f;
+    for (int i = 0; i < inst->polyphony; i++) {
+        HeraVoiceState &voice = inst->voices[i];
+        if (!voice.active || voice.isReleased() != released) continue;
+        float level = voice_level(voice);
+        if (best < 0 || level < bestLevel) {
+            best = i;
+            bestLevel = level;
+        }
+    }
+    return best;
+}
+
 static int find_free_voice(hera_instance_t *inst) {
-    /* First: find an inactive voice */
-    for (int i = 0; i < MAX_VOICES; i++) {
-        if (!inst->voices[i].active) return i;
+    int inactive = -1;
+    for (int i = 0; i < inst->polyphony && inactive < 0; i++) {
+        if (!inst->voices[i].active) inactive = i;
+    }
+
+    /* First: an inactive voice, unless the CPU limiter holds us back */
+    if (inactive >= 0) {
+        if (count_active_voices(inst) < inst->voiceLimit)
+            return inactive;
+
+        /* At the cap: steal the quietest voice, released ones first,
+           rather than start another */
+        inst->limiterInterventions.fetch_add(1, std::memory_order_relaxed);
+        int quietest = find_quietest_voice(inst, true);
+        return (quietest >= 0) ? quietest : find_quietest_voice(inst, false);
     }
 
     /* Second: steal the oldest released voice */
-    for (int i = 0; i < MAX_VOICES; i++) {
-        if (inst->voices[i].isReleased()) return i;
+    for (int i = 0; i < inst->polyphony; i++) {
+        if (inst->voices[i].active && inst->voices[i].isReleased()) return i;
     }
 
     /* Last resort: steal voice 0 */
@@ -636,6 +949,7 @@ static void note_on(hera_instance_t *inst, int note, float velocity) {
     voice.frequency = midi_to_freq(note);
     voice.velocity = velocity;
     voice.vcaType = inst->vcaType;
+    voice.silentSamples = 0;
 
     /* LFO auto-trigger */
     if (inst->lfoMode == kHeraLFOAuto) {
@@ -647,8 +961,8 @@ static void note_on(hera_instance_t *inst, int note, float velocity) {
     voice.getCurrentEnvelope().noteOn();
 
     /* Set DCO frequency */
-    voice.dco.setFrequency(voice.frequency);
-    flushSmoothValues(voice.dco);
+    inst->dcoBank.setFrequency(vi, voice.frequency);
+    inst->dcoBank.flushSmoothValues(vi);
 
     /* Reset PWM smoother */
     voice.smoothPWMDepth.setCurrentAndTargetValue(
@@ -656,7 +970,7 @@ static void note_on(hera_instance_t *inst, int note, float velocity) {
 }
 
 static void note_off(hera_instance_t *inst, int note) {
-    for (int i = 0; i < MAX_VOICES; i++) {
+    for (int i = 0; i < inst->polyphony; i++) {
         HeraVoiceState &voice = inst->voices[i];
         if (voice.active && voice.note == note && !voice.isReleased()) {
             voice.getCurrentEnvelope().noteOff();
@@ -671,8 +985,58 @@ static void note_off(hera_instance_t *inst, int note) {
     }
 }
 
+/* Return a voice to the pool with its DSP state cleared */
+static void retire_voice(hera_instance_t *inst, int v) {
+    HeraVoiceState &voice = inst->voices[v];
+    voice.getCurrentEnvelope().reset();
+    voice.gateEnvelope.reset();
+    inst->dcoBank.clearVoice(v);
+    inst->vcfBank.clearVoice(v);
+    voice.active = false;
+    voice.note = -1;
+}
+
+/* Bring a voice's per-voice settings up to date with inst->params.
+   apply_param only fans out to the first `polyphony` voices. */
+static void sync_voice_params(hera_instance_t *inst, int v) {
+    HeraVoiceState &voice = inst->voices[v];
+    voice.vcaType = inst->vcaType;
+    voice.pwmMod = (int)inst->params[kHeraParamPWMMod];
+    voice.smoothPWMDepth.setCurrentAndTargetValue(inst->params[kHeraParamPWMDepth]);
+}
+
+static void set_polyphony(hera_instance_t *inst, int count) {
+    /* Voices leaving the pool are cut; voices joining it pick up the patch */
+    for (int i = count; i < inst->polyphony; i++) {
+        if (inst->voices[i].active)
+            retire_voice(inst, i);
+    }
+    for (int i = inst->polyphony; i < count; i++)
+        sync_voice_params(inst, i);
+
+    inst->polyphony = count;
+    inst->voiceLimit = std::min(inst->voiceLimit, count);
+
+    if (inst->lfoMode == kHeraLFOAuto && !has_unreleased_voices(inst))
+        inst->lfo.noteOff();
+}
+
+/* Peak level below which a released voice counts as silent */
+static void set_silence_floor(hera_instance_t *inst, float db) {
+    inst->silenceFloorDb = db;
+    inst->silenceThreshold = std::pow(10.0f, inst->silenceFloorDb / 20.0f);
+}
+
+/* Spawns or joins worker threads: control thread only, never from render */
+static void set_render_threads(hera_instance_t *inst, int count) {
+    count = std::max(0, std::min(RENDER_POOL_MAX_WORKERS, count));
+    if (count == inst->renderThreads) return;
+    inst->renderPool.start(count);
+    inst->renderThreads = count;
+}
+
 static void all_notes_off(hera_instance_t *inst) {
-    for (int i = 0; i < MAX_VOICES; i++) {
+    for (int i = 0; i < inst->polyphony; i++) {
         HeraVoiceState &voice = inst->voices[i];
         if (voice.active) {
             voice.getCurrentEnvelope().shutdown();
@@ -682,22 +1046,346 @@ static void all_notes_off(hera_instance_t *inst) {
     }
 }
 
+/* =====================================================================
+ * Control queue
+ * ===================================================================== */
+
+/* Render thread: apply a scalar setting from set_param to the engine */
+static void apply_setting(hera_instance_t *inst, const HeraControlEvent &ev) {
+    switch (ev.type) {
+    case kControlVolume:
+        inst->volume = ev.value;
+        break;
+    case kControlOctaveTranspose:
+        inst->octave_transpose = (int)ev.value;
+        break;
+    case kControlPolyphony:
+        set_polyphony(inst, (int)ev.value);
+        break;
+    case kControlCpuLimit:
+        inst->cpuLimit = ev.value;
+        break;
+    case kControlSilenceFloor:
+        set_silence_floor(inst, ev.value);
+        break;
+    case kControlControlInterval:
+        inst->controlInterval = (int)ev.value;
+        break;
+    case kControlAllNotesOff:
+        all_notes_off(inst);
+        break;
+    }
+}
+
+/* Copy in a compiled preset's engine state in place of apply_param for
+   kHeraCompiledParams */
+static void apply_preset_engine(hera_instance_t *inst, const HeraPresetEngine *engine,
+                                const float *values) {
+    inst->envelopeShape = engine->envelopeShape;
+    inst->lfo.setEnvelopeShape(engine->lfoEnvelopeShape);
+    inst->lfo.setFrequency(engine->lfoFrequency);
+    for (uint32_t m = kHeraCompiledParams; m; m &= m - 1) {
+        int idx = __builtin_ctz(m);
+        inst->params[idx] = values[idx];
+    }
+}
+
+/* Parameter changes popped from the control queue but not yet applied */
+struct HeraStagedParams {
+    uint32_t mask;
+    float values[kHeraNumParameters];
+    const HeraPresetEngine *engine;  /* Compiled preset state, applied first */
+};
+
+static void apply_staged_params(hera_instance_t *inst, HeraStagedParams *s) {
+    if (s->engine)
+        apply_preset_engine(inst, s->engine, s->values);
+    for (uint32_t m = s->mask; m; m &= m - 1) {
+        int idx = __builtin_ctz(m);
+        apply_param(inst, idx, s->values[idx]);
+    }
+    s->engine = NULL;
+    s->mask = 0;
+}
+
+/* Render thread: take one event from set_param. Parameter values are
+   staged under a dirty mask and applied once each, with their last value,
+   before the next event of any other kind (see drain_host_events), so a
+   knob sweep costs at most one apply_param per parameter per run of
+   changes. A preset's compiled engine state replaces its
+   kHeraCompiledParams, and parameters set after it are applied on top. */
+static void take_control_event(hera_instance_t *inst, HeraStagedParams *s,
+                               const HeraControlEvent &ev) {
+    switch (ev.type) {
+    case kControlPreset:
+        apply_staged_params(inst, s);
+        all_notes_off(inst);
+        s->engine = ev.engine;
+        memcpy(s->values, ev.values, sizeof(s->values));
+        s->mask = ev.mask & ~kHeraCompiledParams;
+        break;
+    case kControlParams:
+        for (uint32_t m = ev.mask; m; m &= m - 1) {
+            int idx = __builtin_ctz(m);
+            s->values[idx] = ev.values[idx];
+        }
+        s->mask |= ev.mask;
+        break;
+    default:
+        /* Released notes and voices joining the pool see the parameters
+           set before this event */
+        apply_staged_params(inst, s);
+        apply_setting(inst, ev);
+        break;
+    }
+}
+
+static void handle_midi(hera_instance_t *inst, const uint8_t *msg, int len, int source);
+
+/* Render thread: take everything the host sent since the last block,
+   merging the control and MIDI queues in sequence order. Staged parameter
+   changes are applied before each immediate MIDI event and at the end, so
+   a note sees the settings sent before it and none sent after. Timed MIDI
+   goes into the block's timestamped queue; insertion keeps it sorted and
+   equal frames in arrival order. */
+static void drain_host_events(hera_instance_t *inst) {
+    HeraStagedParams staged;
+    staged.mask = 0;
+    staged.engine = NULL;
+
+    for (;;) {
+        const HeraControlEvent *control = inst->controlQueue.peek();
+        const HeraMidiEvent *midi = inst->midiInbox.peek();
+
+        if (control && (!midi || (int32_t)(control->seq - midi->seq) < 0)) {
+            HeraControlEvent ev;
+            if (inst->controlQueue.pop(ev))
+                take_control_event(inst, &staged, ev);
+        }
+        else if (midi) {
+            HeraMidiEvent ev;
+            if (!inst->midiInbox.pop(ev))
+                break;
+            if (ev.timed && inst->midiQueueCount < MAX_MIDI_EVENTS) {
+                int pos = inst->midiQueueCount++;
+                while (pos > 0 && inst->midiQueue[pos - 1].frame > ev.ev.frame) {
+                    inst->midiQueue[pos] = inst->midiQueue[pos - 1];
+                    pos--;
+                }
+                inst->midiQueue[pos] = ev.ev;
+            }
+            else {
+                /* Immediate, or the timed queue is full: fall back to
+                   block-quantised timing */
+                apply_staged_params(inst, &staged);
+                handle_midi(inst, ev.ev.msg, ev.ev.len, ev.ev.source);
+            }
+        }
+        else {
+            break;
+        }
+    }
+
+    apply_staged_params(inst, &staged);
+}
+
+static uint32_t next_host_event_seq(hera_instance_t *inst) {
+    return inst->hostEventSeq.fetch_add(1, std::memory_order_relaxed);
+}
+
+static bool push_setting(hera_instance_t *inst, int type, float value, uint32_t seq) {
+    HeraControlEvent ev = {};
+    ev.seq = seq;
+    ev.type = type;
+    ev.value = value;
+    return inst->controlQueue.push(ev);
+}
+
+/* Queue every setting, to bring the engine back in line after a drop. A
+   dropped notes-off goes first and keeps its sequence number, so MIDI sent
+   after it and still queued plays after the cut. */
+static bool push_control_state(hera_instance_t *inst) {
+    HeraControlState &c = inst->control;
+    if (c.notesOffPending) {
+        if (!push_setting(inst, kControlAllNotesOff, 0.0f, c.notesOffSeq))
+            return false;
+        c.notesOffPending = false;
+    }
+
+    uint32_t seq = next_host_event_seq(inst);
+    HeraControlEvent ev = {};
+    ev.seq = seq;
+    ev.type = kControlParams;
+    ev.mask = (1u << kHeraNumParameters) - 1;
+    memcpy(ev.values, c.params, sizeof(ev.values));
+    return inst->controlQueue.push(ev) &&
+           push_setting(inst, kControlVolume, c.volume, seq) &&
+           push_setting(inst, kControlOctaveTranspose, c.octave_transpose, seq) &&
+           push_setting(inst, kControlPolyphony, c.polyphony, seq) &&
+           push_setting(inst, kControlCpuLimit, c.cpuLimit, seq) &&
+           push_setting(inst, kControlSilenceFloor, c.silenceFloorDb, seq) &&
+           push_setting(inst, kControlControlInterval, c.controlInterval, seq);
+}
+
+/* Control thread: queue an event. If the queue is full (the audio thread
+   has stalled) the event is dropped and counted, and once there is room
+   again the whole control state is resent ahead of the next event. The
+   control state holds no notes-off, so a dropped one is remembered. */
+static void queue_control(hera_instance_t *inst, HeraControlEvent ev) {
+    HeraControlState &c = inst->control;
+    if (c.resync)
+        c.resync = !push_control_state(inst);
+
+    ev.seq = next_host_event_seq(inst);
+    if (c.resync || !inst->controlQueue.push(ev)) {
+        c.resync = true;
+        if (ev.type == kControlPreset || ev.type == kControlAllNotesOff) {
+            c.notesOffPending = true;
+            c.notesOffSeq = ev.seq;
+        }
+    }
+}
+
+/* Control thread: clamp a scalar setting, record it and queue it */
+static void set_setting(hera_instance_t *inst, int type, float value) {
+    HeraControlState &c = inst->control;
+    switch (type) {
+    case kControlVolume:
+        value = c.volume = std::max(0.0f, std::min(1.0f, value));
+        break;
+    case kControlOctaveTranspose:
+        value = c.octave_transpose = std::max(-3, std::min(3, (int)value));
+        break;
+    case kControlPolyphony:
+        value = c.polyphony = std::max(1, std::min(MAX_VOICES, (int)value));
+        break;
+    case kControlCpuLimit:
+        value = c.cpuLimit = std::max(0.0f, std::min(1.0f, value));
+        break;
+    case kControlSilenceFloor:
+        value = c.silenceFloorDb = std::max(-120.0f, std::min(-40.0f, value));
+        break;
+    case kControlControlInterval:
+        /* Samples between modulation points; 1 keeps modulation at audio rate */
+        value = c.controlInterval = std::max(1, std::min(MAX_CONTROL_INTERVAL, (int)value));
+        break;
+    }
+
+    HeraControlEvent ev = {};
+    ev.type = type;
+    ev.value = value;
+    queue_control(inst, ev);
+}
+
+/* Control thread: record the parameters in mask and queue them as one
+   event, so they reach the engine in the same block */
+static void set_params(hera_instance_t *inst, int type, uint32_t mask, const float *values) {
+    HeraControlEvent ev = {};
+    ev.type = type;
+    ev.mask = mask;
+    for (uint32_t m = mask; m; m &= m - 1) {
+        int idx = __builtin_ctz(m);
+        inst->control.params[idx] = ev.values[idx] = values[idx];
+    }
+    queue_control(inst, ev);
+}
+
+/* Control thread: the preset's values and its compiled engine state go
+   to the render thread as one event */
+static void apply_preset(hera_instance_t *inst, int preset_idx) {
+    if (preset_idx < 0 || preset_idx >= preset_count(inst)) return;
+
+    const HeraPresetEntry *entry = select_preset(inst, preset_idx);
+    memcpy(inst->control.params, entry->preset.values, sizeof(inst->control.params));
+
+    HeraControlEvent ev = {};
+    ev.type = kControlPreset;
+    ev.mask = (1u << kHeraNumParameters) - 1;
+    ev.engine = &entry->engine;
+    memcpy(ev.values, entry->preset.values, sizeof(ev.values));
+    queue_control(inst, ev);
+}
+
+/* =====================================================================
+ * CPU limiter
+ *
+ * Each block's render time is compared against its deadline. When the
+ * load crosses cpuLimit, the quietest released voice is retired (one per
+ * block) and the voice count is capped so new notes steal rather than
+ * grow. The cap is lifted again one voice per block once load drops.
+ * ===================================================================== */
+
+static void update_cpu_limiter(hera_instance_t *inst, int frames, float elapsed_ns) {
+    float deadline_ns = frames * (1e9f / MOVE_SAMPLE_RATE);
+    float load = elapsed_ns / deadline_ns;
+
+    /* Peak-hold with a ~10-block decay, so one slow block counts */
+    float cpuLoad = inst->cpuLoad.load(std::memory_order_relaxed);
+    if (load > cpuLoad)
+        cpuLoad = load;
+    else
+        cpuLoad += (load - cpuLoad) * 0.1f;
+    inst->cpuLoad.store(cpuLoad, std::memory_order_relaxed);
+
+    if (inst->cpuLimit <= 0.0f) {
+        inst->voiceLimit = inst->polyphony;
+        return;
+    }
+
+    if (cpuLoad > inst->cpuLimit) {
+        int victim = find_quietest_voice(inst, true);
+        if (victim >= 0) {
+            retire_voice(inst, victim);
+            inst->limiterInterventions.fetch_add(1, std::memory_order_relaxed);
+        }
+        inst->voiceLimit = std::max(1, count_active_voices(inst));
+    }
+    else if (cpuLoad < inst->cpuLimit * 0.8f && inst->voiceLimit < inst->polyphony) {
+        inst->voiceLimit++;
+    }
+}
+
 /* =====================================================================
  * Audio rendering
  * ===================================================================== */
 
-static void render_voice(hera_instance_t *inst, HeraVoiceState &voice,
-                         float *output, int numSamples) {
-    /* Process envelope */
-    voice.normalEnvelope.processNextBlock(inst->envelopeBuffer, 0, numSamples);
-    if (voice.vcaType != kHeraVCATypeEnvelope) {
-        voice.gateEnvelope.processNextBlock(inst->gateBuffer, 0, numSamples);
+/* Envelopes of one lane group's active voices, four at a time. The gate
+   envelope only runs for voices in gate mode. */
+static void process_group_envelopes(hera_instance_t *inst, int g, uint32_t activeMask,
+                                    int numSamples) {
+    AbstractEnvelope *normal[kSimdLanes] = {};
+    AbstractEnvelope *gate[kSimdLanes] = {};
+    float *normalOut[kSimdLanes] = {};
+    float *gateOut[kSimdLanes] = {};
+    bool anyGate = false;
+
+    for (int l = 0; l < kSimdLanes; l++) {
+        int v = g * kSimdLanes + l;
+        if (!(activeMask & (1u << v))) continue;
+        HeraVoiceState &voice = inst->voices[v];
+        normal[l] = voice.normalEnvelope.getAbstractEnvelope();
+        normalOut[l] = inst->envelopeBuffer[v];
+        if (voice.vcaType != kHeraVCATypeEnvelope) {
+            gate[l] = voice.gateEnvelope.getAbstractEnvelope();
+            gateOut[l] = inst->gateBuffer[v];
+            anyGate = true;
+        }
     }
 
+    AbstractEnvelopex4::process(normal, normalOut, numSamples);
+    if (anyGate)
+        AbstractEnvelopex4::process(gate, gateOut, numSamples);
+}
+
+/* First stage: PWM and cutoff, everything the banks need besides the
+   envelopes, which process_group_envelopes has already run */
+static void prepare_voice(hera_instance_t *inst, int v, int numSamples) {
+    HeraVoiceState &voice = inst->voices[v];
+
     /* Process PWM */
     const float *lfoIn = inst->lfoBuffer;
-    const float *envelopeIn = inst->envelopeBuffer;
-    float *pwmModOut = inst->pwmModBuffer;
+    const float *envelopeIn = inst->envelopeBuffer[v];
+    float *pwmModOut = inst->pwmModBuffer[v];
     switch (voice.pwmMod) {
     default:
         for (int i = 0; i < numSamples; i++)
@@ -713,18 +1401,12 @@ static void render_voice(hera_instance_t *inst, HeraVoiceState &voice,
         break;
     }
 
-    /* Process DCO */
-    const float *detuneOut = inst->detuneBuffer;
-    float *dcoOut = inst->dcoBuffer;
-    compute(voice.dco, { detuneOut, pwmModOut }, { dcoOut }, numSamples);
-
-    /* Process VCF */
-    const float *modEnvelopeIn = inst->envelopeBuffer;
+    /* Process VCF cutoff */
+    const float *modEnvelopeIn = inst->envelopeBuffer[v];
     const float *ampEnvelopeIn = (voice.vcaType == kHeraVCATypeEnvelope) ?
-        inst->envelopeBuffer : inst->gateBuffer;
+        inst->envelopeBuffer[v] : inst->gateBuffer[v];
     const float *cutoffOctaves = inst->cutoffOctavesBuffer;
-    float *cutoff = inst->cutoffBuffer;
-    const float *resonance = inst->resonanceBuffer;
+    float *cutoff = inst->cutoffBuffer[v];
     const float *vcfEnvMod = inst->vcfEnvModBuffer;
     const float *vcfLFODetuneOctaves = inst->vcfLFODetuneOctavesBuffer;
     const float *vcfKeyboardMod = inst->vcfKeyboardModBuffer;
@@ -733,31 +1415,89 @@ static void render_voice(hera_instance_t *inst, HeraVoiceState &voice,
     float filterNoteFactor = (float)(voice.note - 60) * (1.0f / 12.0f);
     float pitchbendFactor = inst->pitchBendSemitones * (48.0f / (12.0f * 7.0f));
 
-    for (int i = 0; i < numSamples; i++) {
+    auto cutoffOctavesAt = [&](int i) {
         float envDetuneOctaves = vcfEnvMod[i] * modEnvelopeIn[i] * 12;
         float lfoDetuneOctaves = vcfLFODetuneOctaves[i] * ampEnvelopeIn[i];
         float keyboardDetuneOctaves = vcfKeyboardMod[i] * filterNoteFactor;
         float filterBendOctaves = vcfBendDepth[i] * pitchbendFactor;
-        cutoff[i] = 7.8f * std::exp2(cutoffOctaves[i] + envDetuneOctaves +
-                    lfoDetuneOctaves + keyboardDetuneOctaves + filterBendOctaves);
-    }
+        return cutoffOctaves[i] + envDetuneOctaves +
+               lfoDetuneOctaves + keyboardDetuneOctaves + filterBendOctaves;
+    };
 
-    voice.vcf.processNextBlock(dcoOut, cutoff, resonance, numSamples);
+    controlRateFillExp2(cutoff, numSamples, inst->controlInterval, 7.8f, cutoffOctavesAt);
+}
+
+/* Second stage: mix the filtered voice, after the DCO and VCF banks ran */
+static void render_voice(hera_instance_t *inst, int v,
+                         float *output, int numSamples) {
+    HeraVoiceState &voice = inst->voices[v];
+    const float *vcfOut = inst->dcoBuffer[v];
+    const float *ampEnvelopeIn = (voice.vcaType == kHeraVCATypeEnvelope) ?
+        inst->envelopeBuffer[v] : inst->gateBuffer[v];
 
-    /* Mix into output — scale by velocity and divide by voice count for headroom */
-    float noteVolume = voice.velocity * voice.velocity * (1.0f / MAX_VOICES);
+    /* Mix into output — scale by velocity and leave headroom for the default voice count */
+    float noteVolume = voice.velocity * voice.velocity * VOICE_MIX_GAIN;
+    float peak = 0.0f;
     for (int i = 0; i < numSamples; i++) {
-        output[i] += dcoOut[i] * ampEnvelopeIn[i] * noteVolume;
+        float out = vcfOut[i] * ampEnvelopeIn[i] * noteVolume;
+        output[i] += out;
+        peak = std::max(peak, std::fabs(out));
     }
 
+    /* Released voices that stay below the silence floor retire early */
+    if (voice.isReleased() && peak < inst->silenceThreshold)
+        voice.silentSamples += numSamples;
+    else
+        voice.silentSamples = 0;
+
     /* Check if voice should be deactivated */
-    if (!voice.getCurrentEnvelope().isActive()) {
-        voice.getCurrentEnvelope().reset();
-        voice.gateEnvelope.reset();
-        voice.dco.instanceClear();
-        voice.vcf.reset();
-        voice.active = false;
-        voice.note = -1;
+    if (!voice.getCurrentEnvelope().isActive() ||
+        voice.silentSamples >= SILENT_SAMPLES_TO_RETIRE) {
+        retire_voice(inst, v);
+    }
+}
+
+/* Render one group of SIMD lanes into its own mix buffer. Groups own
+   disjoint voices and bank lanes, so they may run on different threads. */
+static void render_voice_group(void *ctx, int g) {
+    hera_instance_t *inst = (hera_instance_t*)ctx;
+    const int frames = inst->groupFrames;
+    const int first = g * kSimdLanes;
+    const int last = std::min(first + kSimdLanes, inst->polyphony);
+
+    uint32_t activeMask = 0;
+    for (int v = first; v < last; v++) {
+        if (inst->voices[v].active)
+            activeMask |= 1u << v;
+    }
+
+    inst->groupActive[g] = activeMask != 0;
+    if (!activeMask) return;
+
+    process_group_envelopes(inst, g, activeMask, frames);
+    for (int v = first; v < last; v++) {
+        if (activeMask & (1u << v))
+            prepare_voice(inst, v, frames);
+    }
+
+    const float *pwmIn[MAX_VOICES];
+    const float *cutoffIn[MAX_VOICES];
+    const float *resonanceIn[MAX_VOICES];
+    float *dcoOut[MAX_VOICES];
+    for (int v = first; v < first + kSimdLanes; v++) {
+        pwmIn[v] = inst->pwmModBuffer[v];
+        cutoffIn[v] = inst->cutoffBuffer[v];
+        resonanceIn[v] = inst->resonanceBuffer;
+        dcoOut[v] = inst->dcoBuffer[v];
+    }
+    inst->dcoBank.computeGroup(g, inst->detuneBuffer, pwmIn, dcoOut, activeMask, frames);
+    inst->vcfBank.processGroup(g, dcoOut, cutoffIn, resonanceIn, activeMask, frames);
+
+    float *mix = inst->groupMix[g];
+    memset(mix, 0, frames * sizeof(float));
+    for (int v = first; v < last; v++) {
+        if (activeMask & (1u << v))
+            render_voice(inst, v, mix, frames);
     }
 }
 
@@ -783,14 +1523,165 @@ static int json_get_number(const char *json, const char *key, float *out) {
     return 0;
 }
 
+/* Visit each "key": number member of a flat JSON object in a single pass,
+   calling visit(key, value). Members with string or other non-numeric
+   values, or keys too long to be ours, are skipped. Returns the number of
+   members visited, or -1 if the object is malformed. */
+template <class Visit>
+static int json_for_each_number(const char *json, Visit visit) {
+    const char *p = json;
+    while (isspace((unsigned char)*p)) p++;
+    if (*p++ != '{') return -1;
+
+    int visited = 0;
+    for (;;) {
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '}') return visited;
+        if (*p != '"') return -1;
+
+        const char *key = ++p;
+        while (*p && *p != '"') p += (*p == '\\' && p[1]) ? 2 : 1;
+        if (!*p) return -1;
+        size_t keyLen = p - key;
+        p++;
+
+        while (isspace((unsigned char)*p)) p++;
+        if (*p++ != ':') return -1;
+        while (isspace((unsigned char)*p)) p++;
+
+        char *end;
+        float value = strtof(p, &end);
+        if (end != p) {
+            char keyBuf[64];
+            if (keyLen < sizeof(keyBuf)) {
+                memcpy(keyBuf, key, keyLen);
+                keyBuf[keyLen] = '\0';
+                visit(keyBuf, value);
+                visited++;
+            }
+            p = end;
+        } else if (*p == '"') {
+            for (p++; *p && *p != '"'; p += (*p == '\\' && p[1]) ? 2 : 1) {}
+            if (!*p) return -1;
+            p++;
+        } else {
+            while (*p && *p != ',' && *p != '}') p++;
+        }
+
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == ',') p++;
+        else if (*p != '}') return -1;
+    }
+}
+
+/* =====================================================================
+ * Base64 helpers
+ * ===================================================================== */
+
+static const char g_base64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Returns the length written, excluding the NUL, or -1 if out is too small */
+static int base64_encode(const uint8_t *in, int len, char *out, int out_len) {
+    int needed = (len + 2) / 3 * 4;
+    if (needed + 1 > out_len) return -1;
+
+    char *o = out;
+    for (int i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        *o++ = g_base64_chars[(v >> 18) & 63];
+        *o++ = g_base64_chars[(v >> 12) & 63];
+        *o++ = (i + 1 < len) ? g_base64_chars[(v >> 6) & 63] : '=';
+        *o++ = (i + 2 < len) ? g_base64_chars[v & 63] : '=';
+    }
+    *o = '\0';
+    return needed;
+}
+
+static int base64_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+/* Returns the number of bytes decoded, or -1 on bad input or overflow */
+static int base64_decode(const char *in, uint8_t *out, int out_cap) {
+    int len = 0;
+    uint32_t v = 0;
+    int bits = 0;
+    for (; *in && *in != '='; in++) {
+        int d = base64_value(*in);
+        if (d < 0) return -1;
+        v = (v << 6) | (uint32_t)d;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (len >= out_cap) return -1;
+            out[len++] = (uint8_t)(v >> bits);
+        }
+    }
+    return len;
+}
+
+/* =====================================================================
+ * Instance memory
+ * ===================================================================== */
+
+/* The instance is cache-line aligned, beyond what operator new guarantees */
+static hera_instance_t *alloc_instance() {
+    void *mem = NULL;
+    if (posix_memalign(&mem, alignof(hera_instance_t), sizeof(hera_instance_t)) != 0)
+        return NULL;
+    return new (mem) hera_instance_t();
+}
+
+static void free_instance(hera_instance_t *inst) {
+    inst->~hera_instance_t();
+    free(inst);
+}
+
+/* Log how much of the instance render_block works on. The per-block figure
+   counts what a block of MOVE_FRAMES_PER_BLOCK at the current polyphony
+   actually touches: used buffer rows, used voices and their bank lanes. */
+static void log_memory_footprint(const hera_instance_t *inst) {
+    const char *base = (const char*)inst;
+    size_t render = (size_t)((const char*)&inst->control - base);
+    size_t control = sizeof(hera_instance_t) - render;
+    size_t buffers = (size_t)((const char*)inst->voices - base);
+    size_t voices = sizeof(inst->voices) + 2 * sizeof(HeraEnvelopeShape);
+    size_t banks = sizeof(inst->dcoBank) + sizeof(inst->vcfBank);
+    size_t queues = sizeof(inst->controlQueue) + sizeof(inst->midiInbox);
+    size_t shared = render - buffers - (size_t)((const char*)&inst->lfo - (const char*)inst->voices) - queues;
+
+    int frames = MOVE_FRAMES_PER_BLOCK;
+    int groups = (inst->polyphony + kSimdLanes - 1) / kSimdLanes;
+    size_t row = frames * sizeof(float);
+    size_t perBlock = 11 * row + groups * row +
+                      inst->polyphony * (5 * row + sizeof(HeraVoiceState)) +
+                      banks * groups / VOICE_GROUPS + shared;
+
+    char msg[192];
+    snprintf(msg, sizeof(msg),
+             "Hera v2: render state %u KB (buffers %u, voices %u, banks %u, shared %u, queues %u), "
+             "control state %u KB, touched per block at %d voices ~%u KB",
+             (unsigned)(render / 1024), (unsigned)(buffers / 1024), (unsigned)(voices / 1024),
+             (unsigned)(banks / 1024), (unsigned)(shared / 1024), (unsigned)(queues / 1024),
+             (unsigned)(control / 1024),
+             inst->polyphony, (unsigned)(perBlock / 1024));
+    plugin_log(msg);
+}
+
 /* =====================================================================
  * Plugin API v2 implementation
  * ===================================================================== */
 
 static void* v2_create_instance(const char *module_dir, const char *json_defaults) {
-    (void)json_defaults;
-
-    hera_instance_t *inst = new hera_instance_t();
+    hera_instance_t *inst = alloc_instance();
     if (!inst) return NULL;
 
     memset(inst->module_dir, 0, sizeof(inst->module_dir));
@@ -798,12 +1689,21 @@ static void* v2_create_instance(const char *module_dir, const char *json_default
     inst->output_gain = 1.0f;
     inst->volume = 0.8f;
     inst->pitchFactor = 1.0f;
+    inst->controlInterval = 1;
     inst->vcaType = kHeraVCATypeEnvelope;
     inst->lfoMode = kHeraLFOAuto;
     inst->pitchBendSemitones = 0.0f;
+    inst->midiQueueCount = 0;
     inst->octave_transpose = 0;
+    inst->polyphony = DEFAULT_VOICES;
+    inst->voiceLimit = DEFAULT_VOICES;
+    inst->cpuLimit = DEFAULT_CPU_LIMIT;
+    inst->cpuLoad = 0.0f;
+    inst->limiterInterventions = 0;
+    inst->renderThreads = 0;
+    set_silence_floor(inst, DEFAULT_SILENCE_FLOOR_DB);
     inst->current_preset = 0;
-    inst->preset_count = 0;
+    inst->presetBank = NULL;
     snprintf(inst->preset_name, sizeof(inst->preset_name), "Init");
 
     /* Initialize LFO */
@@ -832,22 +1732,57 @@ static void* v2_create_instance(const char *module_dir, const char *json_default
     inst->vca.init(MOVE_SAMPLE_RATE);
     inst->chorus.init(MOVE_SAMPLE_RATE);
 
+    /* Initialize envelopes: gate mode uses a fast fixed attack/release */
+    inst->envelopeShape.setSampleRate(MOVE_SAMPLE_RATE);
+    inst->gateEnvelopeShape.setSampleRate(MOVE_SAMPLE_RATE);
+    inst->gateEnvelopeShape.setAttack(0.00247f);
+    inst->gateEnvelopeShape.setDecay(0.0057f);
+    inst->gateEnvelopeShape.setSustain(0.98f);
+    inst->gateEnvelopeShape.setRelease(0.0057f);
+
     /* Initialize voices */
     for (int i = 0; i < MAX_VOICES; i++) {
         inst->voices[i].setSampleRate(MOVE_SAMPLE_RATE);
+        inst->voices[i].normalEnvelope.setShape(&inst->envelopeShape);
+        inst->voices[i].gateEnvelope.setShape(&inst->gateEnvelopeShape);
     }
+    inst->dcoBank.init(MOVE_SAMPLE_RATE);
+    inst->vcfBank.init(MOVE_SAMPLE_RATE);
+
+    /* Polyphony can be chosen at creation time */
+    float fval;
+    if (json_defaults && json_get_number(json_defaults, "polyphony", &fval) == 0)
+        inst->polyphony = inst->voiceLimit = std::max(1, std::min(MAX_VOICES, (int)fval));
+    if (json_defaults && json_get_number(json_defaults, "render_threads", &fval) == 0)
+        set_render_threads(inst, (int)fval);
+
+    HeraControlState &c = inst->control;
+    c.volume = inst->volume;
+    c.octave_transpose = inst->octave_transpose;
+    c.polyphony = inst->polyphony;
+    c.cpuLimit = inst->cpuLimit;
+    c.silenceFloorDb = inst->silenceFloorDb;
+    c.controlInterval = inst->controlInterval;
+    c.resync = false;
+    c.notesOffPending = false;
+    inst->hostEventSeq.store(0, std::memory_order_relaxed);
 
     /* Set default parameters */
-    for (int i = 0; i < kHeraNumParameters; i++) {
-        apply_param(inst, i, g_param_defaults[i]);
-    }
+    set_params(inst, kControlParams, (1u << kHeraNumParameters) - 1, g_param_defaults);
 
-    /* Load presets */
-    if (load_presets(inst) > 0) {
+    /* Load presets, or share them with other instances of this module */
+    inst->presetBank = acquire_preset_bank(inst->module_dir);
+    if (preset_count(inst) > 0) {
         inst->current_preset = 0;
         apply_preset(inst, 0);
     }
 
+    /* No render thread yet: the engine takes the initial settings now */
+    drain_host_events(inst);
+    if (inst->presetBank)
+        start_preset_loader(inst->presetBank);
+
+    log_memory_footprint(inst);
     plugin_log("Hera v2: Instance created");
     return inst;
 }
@@ -855,13 +1790,13 @@ static void* v2_create_instance(const char *module_dir, const char *json_default
 static void v2_destroy_instance(void *instance) {
     hera_instance_t *inst = (hera_instance_t*)instance;
     if (!inst) return;
-    delete inst;
+    release_preset_bank(inst->presetBank);
+    free_instance(inst);
     plugin_log("Hera v2: Instance destroyed");
 }
 
-static void v2_on_midi(void *instance, const uint8_t *msg, int len, int source) {
-    hera_instance_t *inst = (hera_instance_t*)instance;
-    if (!inst || len < 2) return;
+static void handle_midi(hera_instance_t *inst, const uint8_t *msg, int len, int source) {
+    if (len < 2) return;
     (void)source;
 
     uint8_t status = msg[0] & 0xF0;
@@ -906,11 +1841,11 @@ static void v2_on_midi(void *instance, const uint8_t *msg, int len, int source)
         inst->pitchBendSemitones = (bend / 8192.0f) * 7.0f;
 
         /* Update all active voice frequencies */
-        float bendFactor = std::exp2(inst->pitchBendSemitones / 12.0f);
-        for (int i = 0; i < MAX_VOICES; i++) {
+        float bendFactor = fastExp2(inst->pitchBendSemitones / 12.0f);
+        for (int i = 0; i < inst->polyphony; i++) {
             if (inst->voices[i].active) {
                 float baseFreq = midi_to_freq(inst->voices[i].note);
-                inst->voices[i].dco.setFrequency(baseFreq * bendFactor);
+                inst->dcoBank.setFrequency(i, baseFreq * bendFactor);
             }
         }
         break;
@@ -918,70 +1853,346 @@ static void v2_on_midi(void *instance, const uint8_t *msg, int len, int source)
     }
 }
 
-static void v2_set_param(void *instance, const char *key, const char *val) {
+/* MIDI is queued for the next render_block; on_midi and on_midi_batch
+   must not be called concurrently with each other. A full inbox drops
+   the event and counts it. */
+static void v2_on_midi(void *instance, const uint8_t *msg, int len, int source) {
     hera_instance_t *inst = (hera_instance_t*)instance;
-    if (!inst) return;
+    if (!inst || !msg || len < 2) return;
+
+    HeraMidiEvent ev = {};
+    ev.seq = next_host_event_seq(inst);
+    ev.timed = false;
+    ev.ev.source = (uint8_t)source;
+    ev.ev.len = (uint8_t)std::min(len, 3);
+    memcpy(ev.ev.msg, msg, ev.ev.len);
+    inst->midiInbox.push(ev);
+}
 
-    /* State restore from patch save */
-    if (strcmp(key, "state") == 0) {
-        float fval;
-
-        if (json_get_number(val, "preset", &fval) == 0) {
-            int idx = (int)fval;
-            if (idx >= 0 && idx < inst->preset_count) {
-                inst->current_preset = idx;
-                apply_preset(inst, idx);
-            }
+static void v2_on_midi_batch(void *instance, const move_midi_event_t *events, int count) {
+    hera_instance_t *inst = (hera_instance_t*)instance;
+    if (!inst || !events) return;
+
+    for (int e = 0; e < count; e++) {
+        HeraMidiEvent ev;
+        ev.seq = next_host_event_seq(inst);
+        ev.timed = true;
+        ev.ev = events[e];
+        ev.ev.len = std::min<uint8_t>(ev.ev.len, 3);
+        inst->midiInbox.push(ev);
+    }
+}
+
+/* =====================================================================
+ * State restore
+ * ===================================================================== */
+
+/* Shared by both state formats: the saved preset is the base and the
+   saved parameters (those set in mask) override it, all queued as one
+   event so each parameter reaches apply_param once. */
+static void apply_restored_params(hera_instance_t *inst, int presetIdx, uint32_t mask,
+                                  float *values) {
+    if (presetIdx >= 0 && presetIdx < preset_count(inst)) {
+        const HeraPreset *p = &select_preset(inst, presetIdx)->preset;
+        for (int i = 0; i < kHeraNumParameters; i++) {
+            if (!(mask & (1u << i)))
+                values[i] = p->values[i];
         }
+        mask = (1u << kHeraNumParameters) - 1;
+    }
+
+    if (mask)
+        set_params(inst, kControlParams, mask, values);
+}
+
+/* =====================================================================
+ * Binary state
+ *
+ * "state_bin" is a base64 blob: a 4-byte header (STATE_BIN_MAGIC and
+ * STATE_BIN_VERSION) followed by fields, each a tag byte, a little-endian
+ * 16-bit length and that many bytes. Readers skip tags they do not know,
+ * so fields can be added without a version bump; the version only changes
+ * if existing fields change meaning. Values are stored as little-endian
+ * 32-bit ints and IEEE floats, encoded byte by byte whatever the host's
+ * order, so a save/load round trip is exact. Restored values are checked
+ * like JSON ones: parameters are clamped to their range and non-finite
+ * floats are ignored.
+ * ===================================================================== */
+
+#define STATE_BIN_MAGIC "HRS"
+#define STATE_BIN_VERSION 1
+#define STATE_BIN_MAX_SIZE 512
+
+enum {
+    kStateTagPreset = 1,        /* int32 */
+    kStateTagVolume,            /* float */
+    kStateTagOctaveTranspose,   /* int32 */
+    kStateTagParams,            /* float[], in kHeraParam order */
+    kStateTagPolyphony,         /* int32 */
+    kStateTagCpuLimit,          /* float */
+    kStateTagSilenceFloor,      /* float, dB */
+    kStateTagControlInterval,   /* int32 */
+};
 
-        if (json_get_number(val, "octave_transpose", &fval) == 0) {
-            inst->octave_transpose = (int)fval;
-            if (inst->octave_transpose < -3) inst->octave_transpose = -3;
-            if (inst->octave_transpose > 3) inst->octave_transpose = 3;
+static int state_bin_put_u32(uint8_t *buf, int pos, uint32_t value) {
+    for (int i = 0; i < 4; i++)
+        buf[pos + i] = (uint8_t)(value >> (8 * i));
+    return pos + 4;
+}
+
+static uint32_t state_bin_get_u32(const uint8_t *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+           ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint32_t float_to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_to_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* Tag and length; the caller writes len bytes after it */
+static int state_bin_put_field(uint8_t *buf, int pos, int tag, int len) {
+    buf[pos] = (uint8_t)tag;
+    buf[pos + 1] = (uint8_t)(len & 0xff);
+    buf[pos + 2] = (uint8_t)(len >> 8);
+    return pos + 3;
+}
+
+static int state_bin_put_int(uint8_t *buf, int pos, int tag, int32_t value) {
+    pos = state_bin_put_field(buf, pos, tag, 4);
+    return state_bin_put_u32(buf, pos, (uint32_t)value);
+}
+
+static int state_bin_put_float(uint8_t *buf, int pos, int tag, float value) {
+    pos = state_bin_put_field(buf, pos, tag, 4);
+    return state_bin_put_u32(buf, pos, float_to_bits(value));
+}
+
+static int state_bin_put_floats(uint8_t *buf, int pos, int tag, const float *values, int count) {
+    pos = state_bin_put_field(buf, pos, tag, count * 4);
+    for (int i = 0; i < count; i++)
+        pos = state_bin_put_u32(buf, pos, float_to_bits(values[i]));
+    return pos;
+}
+
+static int get_state_bin(hera_instance_t *inst, char *buf, int buf_len) {
+    const HeraControlState &c = inst->control;
+    uint8_t bin[STATE_BIN_MAX_SIZE];
+    memcpy(bin, STATE_BIN_MAGIC, 3);
+    bin[3] = STATE_BIN_VERSION;
+
+    int pos = 4;
+    pos = state_bin_put_int(bin, pos, kStateTagPreset, inst->current_preset);
+    pos = state_bin_put_float(bin, pos, kStateTagVolume, c.volume);
+    pos = state_bin_put_int(bin, pos, kStateTagOctaveTranspose, c.octave_transpose);
+    pos = state_bin_put_floats(bin, pos, kStateTagParams, c.params, kHeraNumParameters);
+    pos = state_bin_put_int(bin, pos, kStateTagPolyphony, c.polyphony);
+    pos = state_bin_put_float(bin, pos, kStateTagCpuLimit, c.cpuLimit);
+    pos = state_bin_put_float(bin, pos, kStateTagSilenceFloor, c.silenceFloorDb);
+    pos = state_bin_put_int(bin, pos, kStateTagControlInterval, c.controlInterval);
+
+    return base64_encode(bin, pos, buf, buf_len);
+}
+
+static void restore_state_bin(hera_instance_t *inst, const char *b64) {
+    uint8_t bin[STATE_BIN_MAX_SIZE];
+    int len = base64_decode(b64, bin, sizeof(bin));
+    if (len < 4 || memcmp(bin, STATE_BIN_MAGIC, 3) != 0 || bin[3] != STATE_BIN_VERSION) {
+        plugin_log("state_bin: unrecognised blob, ignored");
+        return;
+    }
+
+    int presetIdx = -1;
+    uint32_t mask = 0;
+    float values[kHeraNumParameters];
+
+    for (int pos = 4; pos + 3 <= len; ) {
+        int tag = bin[pos];
+        int size = bin[pos + 1] | (bin[pos + 2] << 8);
+        const uint8_t *data = bin + pos + 3;
+        pos += 3 + size;
+        if (pos > len) break;
+
+        int32_t i32 = 0;
+        float f32 = 0.0f;
+        bool isFloat = false;   /* A finite float, as float fields must be */
+        if (size == 4) {
+            i32 = (int32_t)state_bin_get_u32(data);
+            f32 = bits_to_float((uint32_t)i32);
+            isFloat = isfinite(f32);
         }
 
-        /* Restore all shadow params */
-        for (int i = 0; i < (int)PARAM_DEF_COUNT(g_shadow_params); i++) {
-            if (json_get_number(val, g_shadow_params[i].key, &fval) == 0) {
-                if (fval < g_shadow_params[i].min_val) fval = g_shadow_params[i].min_val;
-                if (fval > g_shadow_params[i].max_val) fval = g_shadow_params[i].max_val;
-                apply_param(inst, g_shadow_params[i].index, fval);
+        switch (tag) {
+        case kStateTagPreset:
+            if (size == 4) presetIdx = i32;
+            break;
+        case kStateTagVolume:
+            if (isFloat) set_setting(inst, kControlVolume, f32);
+            break;
+        case kStateTagOctaveTranspose:
+            if (size == 4) set_setting(inst, kControlOctaveTranspose, (float)i32);
+            break;
+        case kStateTagParams: {
+            /* Older blobs may hold fewer parameters, newer ones more.
+               Parameters left out of the mask come from the preset. */
+            int count = std::min(size / 4, (int)kHeraNumParameters);
+            mask = 0;
+            for (const param_def_t &def : g_shadow_params) {
+                if (def.index >= count)
+                    continue;
+                float value = bits_to_float(state_bin_get_u32(data + 4 * def.index));
+                if (!isfinite(value))
+                    continue;
+                values[def.index] = std::max(def.min_val, std::min(def.max_val, value));
+                mask |= 1u << def.index;
             }
+            break;
         }
+        case kStateTagPolyphony:
+            if (size == 4) set_setting(inst, kControlPolyphony, (float)i32);
+            break;
+        case kStateTagCpuLimit:
+            if (isFloat) set_setting(inst, kControlCpuLimit, f32);
+            break;
+        case kStateTagSilenceFloor:
+            if (isFloat) set_setting(inst, kControlSilenceFloor, f32);
+            break;
+        case kStateTagControlInterval:
+            if (size == 4) set_setting(inst, kControlControlInterval, (float)i32);
+            break;
+        }
+    }
+
+    apply_restored_params(inst, presetIdx, mask, values);
+}
+
+/* =====================================================================
+ * Text state
+ * ===================================================================== */
+
+/* Restore a "state" object from get_param in one pass over the JSON */
+static void restore_state(hera_instance_t *inst, const char *json) {
+    uint32_t mask = 0;
+    float values[kHeraNumParameters];
+    int presetIdx = -1;
+
+    json_for_each_number(json, [&](const char *name, float fval) {
+        int i = g_shadow_lookup.find(name);
+        if (i >= 0) {
+            if (fval < g_shadow_params[i].min_val) fval = g_shadow_params[i].min_val;
+            if (fval > g_shadow_params[i].max_val) fval = g_shadow_params[i].max_val;
+            values[g_shadow_params[i].index] = fval;
+            mask |= 1u << g_shadow_params[i].index;
+            return;
+        }
+
+        switch (g_plugin_key_lookup.find(name)) {
+        case kKeyPreset:
+            presetIdx = (int)fval;
+            break;
+        case kKeyOctaveTranspose:
+            set_setting(inst, kControlOctaveTranspose, fval);
+            break;
+        case kKeyPolyphony:
+            set_setting(inst, kControlPolyphony, fval);
+            break;
+        case kKeyCpuLimit:
+            set_setting(inst, kControlCpuLimit, fval);
+            break;
+        case kKeySilenceFloor:
+            set_setting(inst, kControlSilenceFloor, fval);
+            break;
+        case kKeyControlInterval:
+            set_setting(inst, kControlControlInterval, fval);
+            break;
+        }
+    });
+
+    apply_restored_params(inst, presetIdx, mask, values);
+}
+
+static void v2_set_param(void *instance, const char *key, const char *val) {
+    hera_instance_t *inst = (hera_instance_t*)instance;
+    if (!inst) return;
+
+    int k = g_plugin_key_lookup.find(key);
+
+    /* State restore from patch save */
+    if (k == kKeyState) {
+        restore_state(inst, val);
+        return;
+    }
+    if (k == kKeyStateBin) {
+        restore_state_bin(inst, val);
+        return;
+    }
+
+    /* Batch of shadow parameters, e.g. {"vcf_cutoff":0.4,"attack":0.1}.
+       Queued as one event, so it is applied together at the start of the
+       next block; a malformed batch is dropped whole. */
+    if (k == kKeyParams) {
+        uint32_t mask = 0;
+        float values[kHeraNumParameters];
+        int visited = json_for_each_number(val, [&](const char *name, float fval) {
+            int i = g_shadow_lookup.find(name);
+            if (i < 0) return;
+            if (fval < g_shadow_params[i].min_val) fval = g_shadow_params[i].min_val;
+            if (fval > g_shadow_params[i].max_val) fval = g_shadow_params[i].max_val;
+            values[g_shadow_params[i].index] = fval;
+            mask |= 1u << g_shadow_params[i].index;
+        });
+        if (visited < 0 || !mask) return;
+
+        set_params(inst, kControlParams, mask, values);
         return;
     }
 
-    if (strcmp(key, "preset") == 0) {
+    if (k == kKeyPreset) {
         int idx = atoi(val);
-        if (idx >= 0 && idx < inst->preset_count && idx != inst->current_preset) {
-            all_notes_off(inst);
-            inst->current_preset = idx;
+        if (idx >= 0 && idx < preset_count(inst) && idx != inst->current_preset)
             apply_preset(inst, idx);
-        }
     }
-    else if (strcmp(key, "volume") == 0) {
-        inst->volume = (float)atof(val);
-        if (inst->volume < 0.0f) inst->volume = 0.0f;
-        if (inst->volume > 1.0f) inst->volume = 1.0f;
+    else if (k == kKeyVolume) {
+        set_setting(inst, kControlVolume, (float)atof(val));
     }
-    else if (strcmp(key, "octave_transpose") == 0) {
-        inst->octave_transpose = atoi(val);
-        if (inst->octave_transpose < -3) inst->octave_transpose = -3;
-        if (inst->octave_transpose > 3) inst->octave_transpose = 3;
+    else if (k == kKeyOctaveTranspose) {
+        set_setting(inst, kControlOctaveTranspose, (float)atoi(val));
     }
-    else if (strcmp(key, "all_notes_off") == 0) {
-        all_notes_off(inst);
+    else if (k == kKeyPolyphony) {
+        set_setting(inst, kControlPolyphony, (float)atoi(val));
+    }
+    else if (k == kKeySilenceFloor) {
+        set_setting(inst, kControlSilenceFloor, (float)atof(val));
+    }
+    else if (k == kKeyCpuLimit) {
+        set_setting(inst, kControlCpuLimit, (float)atof(val));
+    }
+    else if (k == kKeyControlInterval) {
+        set_setting(inst, kControlControlInterval, (float)atoi(val));
+    }
+    else if (k == kKeyRenderThreads) {
+        set_render_threads(inst, atoi(val));
+    }
+    else if (k == kKeyAllNotesOff) {
+        set_setting(inst, kControlAllNotesOff, 0.0f);
     }
     else {
-        /* Named parameter access via helper (for shadow UI) */
-        float fval = (float)atof(val);
-        for (int i = 0; i < (int)PARAM_DEF_COUNT(g_shadow_params); i++) {
-            if (strcmp(key, g_shadow_params[i].key) == 0) {
-                if (fval < g_shadow_params[i].min_val) fval = g_shadow_params[i].min_val;
-                if (fval > g_shadow_params[i].max_val) fval = g_shadow_params[i].max_val;
-                apply_param(inst, g_shadow_params[i].index, fval);
-                return;
-            }
+        /* Named parameter access (for shadow UI) */
+        int i = g_shadow_lookup.find(key);
+        if (i >= 0) {
+            float fval = (float)atof(val);
+            if (fval < g_shadow_params[i].min_val) fval = g_shadow_params[i].min_val;
+            if (fval > g_shadow_params[i].max_val) fval = g_shadow_params[i].max_val;
+            float values[kHeraNumParameters];
+            values[g_shadow_params[i].index] = fval;
+            set_params(inst, kControlParams, 1u << g_shadow_params[i].index, values);
         }
     }
 }
@@ -990,32 +2201,61 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
     hera_instance_t *inst = (hera_instance_t*)instance;
     if (!inst) return -1;
 
-    if (strcmp(key, "preset") == 0) {
+    const HeraControlState &c = inst->control;
+    int k = g_plugin_key_lookup.find(key);
+
+    if (k == kKeyPreset) {
         return snprintf(buf, buf_len, "%d", inst->current_preset);
     }
-    if (strcmp(key, "preset_count") == 0) {
-        return snprintf(buf, buf_len, "%d", inst->preset_count);
+    if (k == kKeyPresetCount) {
+        return snprintf(buf, buf_len, "%d", preset_count(inst));
     }
-    if (strcmp(key, "preset_name") == 0) {
+    if (k == kKeyPresetName) {
         return snprintf(buf, buf_len, "%s", inst->preset_name);
     }
-    if (strcmp(key, "name") == 0) {
+    if (k == kKeyName) {
         return snprintf(buf, buf_len, "Hera");
     }
-    if (strcmp(key, "volume") == 0) {
-        return snprintf(buf, buf_len, "%.3f", inst->volume);
+    if (k == kKeyVolume) {
+        return snprintf(buf, buf_len, "%.3f", c.volume);
+    }
+    if (k == kKeyOctaveTranspose) {
+        return snprintf(buf, buf_len, "%d", c.octave_transpose);
+    }
+    if (k == kKeyPolyphony) {
+        return snprintf(buf, buf_len, "%d", c.polyphony);
+    }
+    if (k == kKeyCpuLimit) {
+        return snprintf(buf, buf_len, "%.3f", c.cpuLimit);
+    }
+    if (k == kKeySilenceFloor) {
+        return snprintf(buf, buf_len, "%.1f", c.silenceFloorDb);
+    }
+    if (k == kKeyControlInterval) {
+        return snprintf(buf, buf_len, "%d", c.controlInterval);
+    }
+    if (k == kKeyRenderThreads) {
+        return snprintf(buf, buf_len, "%d", inst->renderThreads);
+    }
+    if (k == kKeyCpuLoad) {
+        return snprintf(buf, buf_len, "%.3f", inst->cpuLoad.load(std::memory_order_relaxed));
+    }
+    if (k == kKeyLimiterInterventions) {
+        return snprintf(buf, buf_len, "%u", inst->limiterInterventions.load(std::memory_order_relaxed));
+    }
+    if (k == kKeyControlOverflows) {
+        return snprintf(buf, buf_len, "%u", inst->controlQueue.overflows());
     }
-    if (strcmp(key, "octave_transpose") == 0) {
-        return snprintf(buf, buf_len, "%d", inst->octave_transpose);
+    if (k == kKeyMidiOverflows) {
+        return snprintf(buf, buf_len, "%u", inst->midiInbox.overflows());
     }
 
-    /* Named parameter access via helper */
-    int result = param_helper_get(g_shadow_params, PARAM_DEF_COUNT(g_shadow_params),
-                                  inst->params, key, buf, buf_len);
-    if (result >= 0) return result;
+    /* Named parameter access */
+    int i = g_shadow_lookup.find(key);
+    if (i >= 0) return param_helper_format(&g_shadow_params[i], c.params, buf, buf_len);
 
     /* UI hierarchy for shadow parameter editor */
-    if (strcmp(key, "ui_hierarchy") == 0) {
+    if (k == kKeyUiHierarchy) {
         const char *hierarchy = "{"
             "\"modes\":null,"
             "\"levels\":{"
@@ -1046,8 +2286,8 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
                 "},"
                 "\"vca\":{"
                     "\"children\":null,"
-                    "\"knobs\":[\"vca_depth\",\"vca_type\"],"
-                    "\"params\":[\"vca_depth\",\"vca_type\"]"
+                    "\"knobs\":[\"vca_depth\",\"vca_type\",\"polyphony\"],"
+                    "\"params\":[\"vca_depth\",\"vca_type\",\"polyphony\"]"
                 "},"
                 "\"env\":{"
                     "\"children\":null,"
@@ -1075,15 +2315,16 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
     }
 
     /* State serialization for patch save/load */
-    if (strcmp(key, "state") == 0) {
+    if (k == kKeyState) {
         int offset = 0;
         offset += snprintf(buf + offset, buf_len - offset,
-            "{\"preset\":%d,\"volume\":%.4f,\"octave_transpose\":%d",
-            inst->current_preset, inst->volume, inst->octave_transpose);
+            "{\"preset\":%d,\"volume\":%.4f,\"octave_transpose\":%d,\"polyphony\":%d,\"cpu_limit\":%.4f,\"silence_floor\":%.1f,\"control_interval\":%d",
+            inst->current_preset, c.volume, c.octave_transpose, c.polyphony,
+            c.cpuLimit, c.silenceFloorDb, c.controlInterval);
         if (offset >= buf_len) return -1;
 
         for (int i = 0; i < (int)PARAM_DEF_COUNT(g_shadow_params); i++) {
-            float val = inst->params[g_shadow_params[i].index];
+            float val = c.params[g_shadow_params[i].index];
             offset += snprintf(buf + offset, buf_len - offset,
                 ",\"%s\":%.4f", g_shadow_params[i].key, val);
             if (offset >= buf_len) return -1;
@@ -1094,13 +2335,23 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
         return offset;
     }
 
+    /* Compact binary state, see get_state_bin */
+    if (k == kKeyStateBin) {
+        return get_state_bin(inst, buf, buf_len);
+    }
+
     /* Chain params metadata */
-    if (strcmp(key, "chain_params") == 0) {
+    if (k == kKeyChainParams) {
         int offset = 0;
         offset += snprintf(buf + offset, buf_len - offset,
             "[{\"key\":\"preset\",\"name\":\"Preset\",\"type\":\"int\",\"min\":0,\"max\":9999},"
             "{\"key\":\"volume\",\"name\":\"Volume\",\"type\":\"float\",\"min\":0,\"max\":1},"
-            "{\"key\":\"octave_transpose\",\"name\":\"Octave\",\"type\":\"int\",\"min\":-3,\"max\":3}");
+            "{\"key\":\"octave_transpose\",\"name\":\"Octave\",\"type\":\"int\",\"min\":-3,\"max\":3},"
+            "{\"key\":\"polyphony\",\"name\":\"Voices\",\"type\":\"int\",\"min\":1,\"max\":%d},"
+            "{\"key\":\"cpu_limit\",\"name\":\"CPU Limit\",\"type\":\"float\",\"min\":0,\"max\":1},"
+            "{\"key\":\"control_interval\",\"name\":\"Mod Interval\",\"type\":\"int\",\"min\":1,\"max\":%d},"
+            "{\"key\":\"render_threads\",\"name\":\"Render Threads\",\"type\":\"int\",\"min\":0,\"max\":%d},"
+            "{\"key\":\"silence_floor\",\"name\":\"Silence Floor\",\"type\":\"float\",\"min\":-120,\"max\":-40}", MAX_VOICES, MAX_CONTROL_INTERVAL, RENDER_POOL_MAX_WORKERS);
 
         for (int i = 0; i < (int)PARAM_DEF_COUNT(g_shadow_params) && offset < buf_len - 100; i++) {
             offset += snprintf(buf + offset, buf_len - offset,
@@ -1118,15 +2369,8 @@ static int v2_get_param(void *instance, const char *key, char *buf, int buf_len)
     return -1;
 }
 
-static void v2_render_block(void *instance, int16_t *out_interleaved_lr, int frames) {
-    hera_instance_t *inst = (hera_instance_t*)instance;
-    if (!inst) {
-        memset(out_interleaved_lr, 0, frames * 4);
-        return;
-    }
-
-    if (frames > MAX_BLOCK_SIZE) frames = MAX_BLOCK_SIZE;
-
+/* Render one span of the block; queued MIDI events fall between spans */
+static void render_frames(hera_instance_t *inst, int16_t *out_interleaved_lr, int frames) {
     /* Clear mix buffer */
     memset(inst->mixBuffer, 0, frames * sizeof(float));
 
@@ -1134,11 +2378,15 @@ static void v2_render_block(void *instance, int16_t *out_interleaved_lr, int fra
     inst->lfo.processBlock(inst->lfoBuffer, frames);
 
     /* Process detune (pitch modulation from LFO) */
-    float detuneFactor = inst->pitchFactor;
     for (int i = 0; i < frames; i++) {
-        inst->detuneBuffer[i] = detuneFactor *
-            std::exp2(inst->lfoBuffer[i] * 0.25f *
-                      inst->smoothPitchModDepth.getNextValue());
+        inst->detuneBuffer[i] = inst->lfoBuffer[i] * 0.25f *
+            inst->smoothPitchModDepth.getNextValue();
+    }
+    {
+        /* In place: each point is read before the fill reaches it */
+        const float *octaves = inst->detuneBuffer;
+        controlRateFillExp2(inst->detuneBuffer, frames, inst->controlInterval,
+                            inst->pitchFactor, [=](int i) { return octaves[i]; });
     }
 
     /* Process cutoff and resonance smoothing */
@@ -1158,11 +2406,17 @@ static void v2_render_block(void *instance, int16_t *out_interleaved_lr, int fra
         inst->vcfBendDepthBuffer[i] = inst->smoothVCFBendDepth.getNextValue();
     }
 
-    /* Render all active voices into mix buffer */
-    for (int v = 0; v < MAX_VOICES; v++) {
-        if (inst->voices[v].active) {
-            render_voice(inst, inst->voices[v], inst->mixBuffer, frames);
-        }
+    /* Render all active voices: DCO and VCF run four voices at once, in
+       SIMD lanes, and each group of lanes is one job for the render pool */
+    int numGroups = (inst->polyphony + kSimdLanes - 1) / kSimdLanes;
+    inst->groupFrames = frames;
+    inst->renderPool.run(render_voice_group, inst, numGroups);
+
+    for (int g = 0; g < numGroups; g++) {
+        if (!inst->groupActive[g]) continue;
+        const float *mix = inst->groupMix[g];
+        for (int i = 0; i < frames; i++)
+            inst->mixBuffer[i] += mix[i];
     }
 
     /* Apply HPF (mono, in-place) */
@@ -1208,6 +2462,43 @@ static void v2_render_block(void *instance, int16_t *out_interleaved_lr, int fra
     }
 }
 
+static void v2_render_block(void *instance, int16_t *out_interleaved_lr, int frames) {
+    hera_instance_t *inst = (hera_instance_t*)instance;
+    if (!inst) {
+        memset(out_interleaved_lr, 0, frames * 4);
+        return;
+    }
+
+    if (frames > MAX_BLOCK_SIZE) frames = MAX_BLOCK_SIZE;
+
+    /* Changes and MIDI queued since the last block, in the order sent */
+    drain_host_events(inst);
+
+    struct timespec renderStart, renderEnd;
+    clock_gettime(CLOCK_MONOTONIC, &renderStart);
+
+    /* Split the block at queued event offsets. Events stamped past the
+       end of the block are applied after it, i.e. at the next boundary. */
+    int pos = 0;
+    for (int e = 0; e < inst->midiQueueCount; e++) {
+        const move_midi_event_t &ev = inst->midiQueue[e];
+        int frame = std::min<int>(ev.frame, frames);
+        if (frame > pos) {
+            render_frames(inst, out_interleaved_lr + pos * 2, frame - pos);
+            pos = frame;
+        }
+        handle_midi(inst, ev.msg, ev.len, ev.source);
+    }
+    inst->midiQueueCount = 0;
+    if (pos < frames)
+        render_frames(inst, out_interleaved_lr + pos * 2, frames - pos);
+
+    clock_gettime(CLOCK_MONOTONIC, &renderEnd);
+    float elapsed_ns = (float)(renderEnd.tv_sec - renderStart.tv_sec) * 1e9f +
+                       (float)(renderEnd.tv_nsec - renderStart.tv_nsec);
+    update_cpu_limiter(inst, frames, elapsed_ns);
+}
+
 static int v2_get_error(void *instance, char *buf, int buf_len) {
     (void)instance;
     (void)buf;
@@ -1233,6 +2524,7 @@ extern "C" plugin_api_v2_t* move_plugin_init_v2(const host_api_v1_t *host) {
     g_plugin_api_v2.get_param = v2_get_param;
     g_plugin_api_v2.get_error = v2_get_error;
     g_plugin_api_v2.render_block = v2_render_block;
+    g_plugin_api_v2.on_midi_batch = v2_on_midi_batch;
 
     return &g_plugin_api_v2;
 }
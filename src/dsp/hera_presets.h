@@ -0,0 +1,252 @@
+/*
+ * hera_presets.h - Hera parameter IDs and preset formats
+ *
+ * Shared by the plugin and by the preset compiler (tools/presetc.cpp), so
+ * both agree on parameter order and on how an XML preset is read.
+ *
+ * Presets ship as Hera XML files (<PROGRAM name="..."/> followed by
+ * <PARAM id="..." value="..."/>). The build also compiles them into a
+ * binary bank, presets.bin: a HeraBankHeader followed by `count`
+ * HeraPreset records, little-endian, as on every target. The header
+ * carries a hash of the parameter IDs, so a bank built against a different
+ * parameter list is rejected rather than misread.
+ */
+
+#ifndef HERA_PRESETS_H
+#define HERA_PRESETS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "key_lookup.h"
+
+/* Hera parameter indices (matching original Hera) */
+enum {
+    kHeraParamVCA,
+    kHeraParamVCAType,
+    kHeraParamPWMDepth,
+    kHeraParamPWMMod,
+    kHeraParamSawLevel,
+    kHeraParamPulseLevel,
+    kHeraParamSubLevel,
+    kHeraParamNoiseLevel,
+    kHeraParamPitchRange,
+    kHeraParamPitchModDepth,
+    kHeraParamVCFCutoff,
+    kHeraParamVCFResonance,
+    kHeraParamVCFEnvelopeModDepth,
+    kHeraParamVCFLFOModDepth,
+    kHeraParamVCFKeyboardModDepth,
+    kHeraParamVCFBendDepth,
+    kHeraParamAttack,
+    kHeraParamDecay,
+    kHeraParamSustain,
+    kHeraParamRelease,
+    kHeraParamLFOTriggerMode,
+    kHeraParamLFORate,
+    kHeraParamLFODelay,
+    kHeraParamHPF,
+    kHeraParamChorusI,
+    kHeraParamChorusII,
+    kHeraNumParameters,
+};
+
+/* =====================================================================
+ * Preset structure
+ * ===================================================================== */
+
+/* Also the record layout of the binary bank */
+struct HeraPreset {
+    char name[64];
+    float values[kHeraNumParameters];
+};
+
+static_assert(sizeof(HeraPreset) == 64 + 4 * kHeraNumParameters, "HeraPreset must not be padded");
+
+/* =====================================================================
+ * Parameter IDs (strings used in XML presets)
+ * ===================================================================== */
+
+static constexpr const char* g_param_ids[kHeraNumParameters] = {
+    "VCADepth",          /* kHeraParamVCA */
+    "VCAType",           /* kHeraParamVCAType */
+    "DCOPWMDepth",       /* kHeraParamPWMDepth */
+    "DCOPWMMod",         /* kHeraParamPWMMod */
+    "DCOSawLevel",       /* kHeraParamSawLevel */
+    "DCOPulseLevel",     /* kHeraParamPulseLevel */
+    "DCOSubLevel",       /* kHeraParamSubLevel */
+    "DCONoiseLevel",     /* kHeraParamNoiseLevel */
+    "DCORange",          /* kHeraParamPitchRange */
+    "DCOPitchModDepth",  /* kHeraParamPitchModDepth */
+    "VCFCutoff",         /* kHeraParamVCFCutoff */
+    "VCFResonance",      /* kHeraParamVCFResonance */
+    "VCFEnv",            /* kHeraParamVCFEnvelopeModDepth */
+    "VCFLFO",            /* kHeraParamVCFLFOModDepth */
+    "VCFKey",            /* kHeraParamVCFKeyboardModDepth */
+    "VCFBendDepth",      /* kHeraParamVCFBendDepth */
+    "ENVAttack",         /* kHeraParamAttack */
+    "ENVDecay",          /* kHeraParamDecay */
+    "ENVSustain",        /* kHeraParamSustain */
+    "ENVRelease",        /* kHeraParamRelease */
+    "LFOTrigMode",       /* kHeraParamLFOTriggerMode */
+    "LFORate",           /* kHeraParamLFORate */
+    "LFODelay",          /* kHeraParamLFODelay */
+    "HPF",               /* kHeraParamHPF */
+    "ChorusI",           /* kHeraParamChorusI */
+    "ChorusII",          /* kHeraParamChorusII */
+};
+
+static constexpr auto g_param_id_lookup = makeKeyLookup<64>(g_param_ids);
+
+/* Default parameter values, for IDs a preset leaves out */
+static const float g_param_defaults[kHeraNumParameters] = {
+    0.5f,   /* VCA depth */
+    0.0f,   /* VCA type (envelope) */
+    0.5f,   /* PWM depth */
+    0.0f,   /* PWM mod (manual) */
+    1.0f,   /* Saw level */
+    0.0f,   /* Pulse level */
+    0.0f,   /* Sub level */
+    0.0f,   /* Noise level */
+    1.0f,   /* Pitch range (8') */
+    0.0f,   /* Pitch mod depth */
+    0.5f,   /* VCF cutoff */
+    0.0f,   /* VCF resonance */
+    0.0f,   /* VCF envelope mod depth */
+    0.0f,   /* VCF LFO mod depth */
+    0.0f,   /* VCF keyboard mod depth */
+    0.0f,   /* VCF bend depth */
+    0.0f,   /* Attack */
+    0.0f,   /* Decay */
+    0.0f,   /* Sustain */
+    0.0f,   /* Release */
+    1.0f,   /* LFO trigger mode (auto) */
+    0.0f,   /* LFO rate */
+    0.0f,   /* LFO delay */
+    0.0f,   /* HPF */
+    0.0f,   /* Chorus I */
+    0.0f,   /* Chorus II */
+};
+
+/* =====================================================================
+ * Binary bank
+ * ===================================================================== */
+
+#define HERA_BANK_MAGIC "HRPB"
+#define HERA_BANK_VERSION 1
+
+struct HeraBankHeader {
+    char magic[4];            /* HERA_BANK_MAGIC */
+    uint32_t version;         /* HERA_BANK_VERSION */
+    uint32_t num_params;      /* kHeraNumParameters */
+    uint32_t param_ids_hash;  /* hera_param_ids_hash() */
+    uint32_t count;           /* Number of HeraPreset records that follow */
+};
+
+/* FNV-1a over the parameter IDs, in order */
+static inline uint32_t hera_param_ids_hash() {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < kHeraNumParameters; i++) {
+        for (const char *c = g_param_ids[i]; ; c++) {
+            h = (h ^ (uint8_t)*c) * 16777619u;
+            if (!*c) break;
+        }
+    }
+    return h;
+}
+
+static inline void hera_bank_header_init(HeraBankHeader *h, uint32_t count) {
+    memcpy(h->magic, HERA_BANK_MAGIC, sizeof(h->magic));
+    h->version = HERA_BANK_VERSION;
+    h->num_params = kHeraNumParameters;
+    h->param_ids_hash = hera_param_ids_hash();
+    h->count = count;
+}
+
+/* Number of records if the header matches this build, -1 otherwise */
+static inline int hera_bank_header_check(const HeraBankHeader *h) {
+    if (memcmp(h->magic, HERA_BANK_MAGIC, sizeof(h->magic)) != 0) return -1;
+    if (h->version != HERA_BANK_VERSION) return -1;
+    if (h->num_params != kHeraNumParameters) return -1;
+    if (h->param_ids_hash != hera_param_ids_hash()) return -1;
+    if (h->count > INT32_MAX / sizeof(HeraPreset)) return -1;
+    return (int)h->count;
+}
+
+/* =====================================================================
+ * XML presets
+ * ===================================================================== */
+
+/* Simple XML attribute parser */
+static inline const char* find_xml_attr(const char *xml, const char *attr_name, char *buf, int buf_len) {
+    char search[64];
+    snprintf(search, sizeof(search), "%s=\"", attr_name);
+    const char *pos = strstr(xml, search);
+    if (!pos) return NULL;
+
+    pos += strlen(search);
+    const char *end = strchr(pos, '"');
+    if (!end) return NULL;
+
+    int len = end - pos;
+    if (len >= buf_len) len = buf_len - 1;
+    strncpy(buf, pos, len);
+    buf[len] = '\0';
+    return end + 1;
+}
+
+/* Fill p from the text of an XML preset; missing values take defaults */
+static inline void parse_preset_xml(const char *data, HeraPreset *p, int preset_idx) {
+    memset(p, 0, sizeof(HeraPreset));
+
+    /* Set defaults */
+    for (int i = 0; i < kHeraNumParameters; i++)
+        p->values[i] = g_param_defaults[i];
+
+    /* Extract preset name from <PROGRAM name="..."/> */
+    char name_buf[64];
+    if (find_xml_attr(data, "name", name_buf, sizeof(name_buf))) {
+        strncpy(p->name, name_buf, sizeof(p->name) - 1);
+    } else {
+        snprintf(p->name, sizeof(p->name), "Preset %d", preset_idx);
+    }
+
+    /* Extract parameter values from <PARAM id="..." value="..."/> */
+    const char *pos = data;
+    while ((pos = strstr(pos, "<PARAM ")) != NULL) {
+        char id_buf[64], val_buf[32];
+        if (find_xml_attr(pos, "id", id_buf, sizeof(id_buf)) &&
+            find_xml_attr(pos, "value", val_buf, sizeof(val_buf))) {
+
+            int i = g_param_id_lookup.find(id_buf);
+            if (i >= 0)
+                p->values[i] = atof(val_buf);
+        }
+        pos++;
+    }
+}
+
+/* Read a whole XML preset file into a malloc'd, NUL-terminated buffer.
+   Returns NULL if the file is missing (*exists false) or unusable. */
+static inline char *read_preset_file(const char *path, bool *exists) {
+    FILE *f = fopen(path, "rb");
+    *exists = (f != NULL);
+    if (!f) return NULL;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (size <= 0 || size > 65536) { fclose(f); return NULL; }
+
+    char *data = (char*)malloc(size + 1);
+    if (!data) { fclose(f); return NULL; }
+    size_t got = fread(data, 1, size, f);
+    data[got] = '\0';
+    fclose(f);
+    return data;
+}
+
+#endif /* HERA_PRESETS_H */
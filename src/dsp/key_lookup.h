@@ -0,0 +1,91 @@
+/*
+ * key_lookup.h - Compile-time perfect hash from key strings to table indices
+ *
+ * makeKeyLookup<Size>(keys) runs at compile time over a constexpr table of
+ * N distinct keys. It searches for a hash seed under which every key lands
+ * in its own slot of a Size-entry table (Size a power of two, a few times
+ * N), so find() is one hash, one load and one strcmp to reject unknown
+ * keys. Duplicate keys make the search fail, which is a compile error.
+ *
+ * Usage:
+ *   static constexpr const char *my_keys[] = { "a", "b", ... };
+ *   static constexpr auto my_lookup = makeKeyLookup<64>(my_keys);
+ *   int idx = my_lookup.find(key);  // index into my_keys, or -1
+ *
+ * Tables of structs pass a pointer to their key member instead:
+ *   makeKeyLookup<64>(my_defs, &my_def_t::key)
+ */
+
+#ifndef KEY_LOOKUP_H
+#define KEY_LOOKUP_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* FNV-1a from a seeded basis, with a final mix so the low bits used for
+   the slot depend on every character */
+static constexpr uint32_t keyHash(const char *key, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (; *key; key++)
+        h = (h ^ (uint8_t)*key) * 16777619u;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+template <int N, int Size>
+struct KeyLookup {
+    static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+    static_assert(Size >= 2 * N, "Size should leave the table at most half full");
+
+    uint32_t seed;
+    const char *keys[N];
+    int16_t slots[Size];  /* Index into keys, or -1 */
+
+    int find(const char *key) const {
+        int i = slots[keyHash(key, seed) & (Size - 1)];
+        return (i >= 0 && strcmp(key, keys[i]) == 0) ? i : -1;
+    }
+};
+
+namespace KeyLookupDetail {
+template <int N, int Size>
+constexpr bool trySeed(KeyLookup<N, Size> &t, uint32_t seed) {
+    for (int s = 0; s < Size; s++)
+        t.slots[s] = -1;
+    for (int i = 0; i < N; i++) {
+        int s = keyHash(t.keys[i], seed) & (Size - 1);
+        if (t.slots[s] >= 0) return false;
+        t.slots[s] = (int16_t)i;
+    }
+    t.seed = seed;
+    return true;
+}
+
+template <int N, int Size>
+constexpr KeyLookup<N, Size> build(KeyLookup<N, Size> t) {
+    for (uint32_t seed = 0; seed < 4096; seed++) {
+        if (trySeed(t, seed)) return t;
+    }
+    throw "makeKeyLookup: no perfect hash found (duplicate keys?)";
+}
+} // namespace KeyLookupDetail
+
+template <int Size, int N>
+constexpr KeyLookup<N, Size> makeKeyLookup(const char *const (&keys)[N]) {
+    KeyLookup<N, Size> t = {};
+    for (int i = 0; i < N; i++)
+        t.keys[i] = keys[i];
+    return KeyLookupDetail::build(t);
+}
+
+template <int Size, class T, int N>
+constexpr KeyLookup<N, Size> makeKeyLookup(const T (&table)[N], const char *T::*key) {
+    KeyLookup<N, Size> t = {};
+    for (int i = 0; i < N; i++)
+        t.keys[i] = table[i].*key;
+    return KeyLookupDetail::build(t);
+}
+
+#endif /* KEY_LOOKUP_H */
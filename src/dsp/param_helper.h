@@ -33,6 +33,23 @@ typedef struct {
     float max_val;        /* Maximum value */
 } param_def_t;
 
+/*
+ * Format the value of one parameter, for callers that found its definition.
+ * Returns: length written to buf
+ */
+static inline int param_helper_format(
+    const param_def_t *def,
+    const float *values,
+    char *buf,
+    int buf_len
+) {
+    if (def->type == PARAM_TYPE_INT) {
+        return snprintf(buf, buf_len, "%d", (int)values[def->index]);
+    } else {
+        return snprintf(buf, buf_len, "%.3f", values[def->index]);
+    }
+}
+
 /*
  * Get a parameter value by key.
  * Returns: length written to buf, or -1 if key not found
@@ -47,11 +64,7 @@ static inline int param_helper_get(
 ) {
     for (int i = 0; i < def_count; i++) {
         if (strcmp(key, defs[i].key) == 0) {
-            if (defs[i].type == PARAM_TYPE_INT) {
-                return snprintf(buf, buf_len, "%d", (int)values[defs[i].index]);
-            } else {
-                return snprintf(buf, buf_len, "%.3f", values[defs[i].index]);
-            }
+            return param_helper_format(&defs[i], values, buf, buf_len);
         }
     }
     return -1;  /* Key not found */
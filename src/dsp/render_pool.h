@@ -0,0 +1,188 @@
+/*
+ * render_pool.h - Optional worker threads for splitting render work
+ *
+ * The audio thread calls run() with a job function and a job count. The
+ * jobs are claimed from a shared counter by the audio thread itself and by
+ * any workers, so run() never waits on a worker that has not started a job:
+ * it only spins until jobs already claimed are done. Nothing on the run()
+ * path allocates, locks, or blocks.
+ *
+ * Workers sleep on a futex between blocks. start()/stop() create and join
+ * threads and belong on a control thread. Each worker takes on the
+ * scheduling policy and priority of the thread calling run() itself, the
+ * first time it wakes for that thread, so the syscalls stay off the audio
+ * thread.
+ */
+
+#ifndef RENDER_POOL_H
+#define RENDER_POOL_H
+
+#include <atomic>
+#include <thread>
+#include <climits>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define RENDER_POOL_MAX_WORKERS 3
+
+class RenderPool {
+public:
+    typedef void (*JobFn)(void *ctx, int job);
+
+    RenderPool() {}
+    ~RenderPool() { stop(); }
+
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+
+    int workerCount() const { return numWorkers_; }
+
+    /* Control thread: (re)start with the given number of workers, 0 stops */
+    void start(int numWorkers) {
+        stop();
+        if (numWorkers > RENDER_POOL_MAX_WORKERS) numWorkers = RENDER_POOL_MAX_WORKERS;
+        if (numWorkers <= 0) return;
+
+        quit_.store(false);
+        for (int i = 0; i < numWorkers; i++)
+            workers_[i] = std::thread(&RenderPool::workerMain, this);
+        numWorkers_ = numWorkers;
+        enabled_.store(true);
+    }
+
+    void stop() {
+        if (numWorkers_ == 0) return;
+
+        /* Pairs with run(): either run() sees !enabled_, or we see busy_ */
+        enabled_.store(false);
+        while (busy_.load())
+            std::this_thread::yield();
+
+        quit_.store(true);
+        wakeSeq_.fetch_add(1);
+        futex(&wakeSeq_, FUTEX_WAKE_PRIVATE, INT_MAX);
+        for (int i = 0; i < numWorkers_; i++)
+            workers_[i].join();
+        numWorkers_ = 0;
+    }
+
+    /* Audio thread: run fn(ctx, 0..numJobs-1), return when all are done */
+    void run(JobFn fn, void *ctx, int numJobs) {
+        busy_.store(true);
+        if (!enabled_.load() || numJobs <= 1) {
+            busy_.store(false);
+            for (int j = 0; j < numJobs; j++)
+                fn(ctx, j);
+            return;
+        }
+
+        /* Workers copy this thread's scheduling when they wake, see syncPriority */
+        pthread_t self = pthread_self();
+        if (runThreadSeq_.load(std::memory_order_relaxed) == 0 ||
+            !pthread_equal(self, runThread_.load(std::memory_order_relaxed))) {
+            runThread_.store(self, std::memory_order_relaxed);
+            runThreadSeq_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        fn_ = fn;
+        ctx_ = ctx;
+        done_.store(0, std::memory_order_relaxed);
+        uint32_t gen = ++generation_;
+        claim_.store(packClaim(gen, numJobs, 0), std::memory_order_release);
+
+        wakeSeq_.fetch_add(1, std::memory_order_release);
+        futex(&wakeSeq_, FUTEX_WAKE_PRIVATE, numWorkers_);
+
+        runJobs(gen);
+        while (done_.load(std::memory_order_acquire) < numJobs)
+            cpuRelax();
+
+        busy_.store(false);
+    }
+
+private:
+    /* Generation, job count and next job index, in one word so that a
+       worker never reads a count that run() is rewriting */
+    static uint64_t packClaim(uint32_t gen, int numJobs, int next) {
+        return ((uint64_t)gen << 32) | ((uint64_t)(uint16_t)numJobs << 16) | (uint16_t)next;
+    }
+
+    /* Claim and run jobs of generation `gen` until none are left */
+    void runJobs(uint32_t gen) {
+        for (;;) {
+            uint64_t cur = claim_.load(std::memory_order_acquire);
+            for (;;) {
+                if ((uint32_t)(cur >> 32) != gen) return;
+                if ((uint16_t)cur >= (uint16_t)(cur >> 16)) return;
+                if (claim_.compare_exchange_weak(cur, cur + 1, std::memory_order_acq_rel))
+                    break;
+            }
+            /* fn_/ctx_ stay valid: run() cannot finish before this job does */
+            fn_(ctx_, (int)(uint16_t)cur);
+            done_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    /* Worker, after a wake: take on the scheduling of the thread calling
+       run(), once per such thread. That is the host's audio thread, which
+       outlives the plugin instance. */
+    void syncPriority(uint32_t *syncedSeq) {
+        uint32_t seq = runThreadSeq_.load(std::memory_order_relaxed);
+        if (seq == *syncedSeq) return;
+
+        int policy;
+        struct sched_param param;
+        if (pthread_getschedparam(runThread_.load(std::memory_order_relaxed), &policy, &param) == 0)
+            pthread_setschedparam(pthread_self(), policy, &param);
+        *syncedSeq = seq;
+    }
+
+    void workerMain() {
+        uint32_t seq = wakeSeq_.load(std::memory_order_acquire);
+        uint32_t syncedSeq = 0;
+        while (!quit_.load(std::memory_order_acquire)) {
+            syncPriority(&syncedSeq);
+            runJobs((uint32_t)(claim_.load(std::memory_order_acquire) >> 32));
+            futex(&wakeSeq_, FUTEX_WAIT_PRIVATE, seq);
+            seq = wakeSeq_.load(std::memory_order_acquire);
+        }
+    }
+
+    static long futex(std::atomic<uint32_t> *addr, int op, uint32_t val) {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val, NULL, NULL, 0);
+    }
+
+    static void cpuRelax() {
+#if defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+private:
+    std::thread workers_[RENDER_POOL_MAX_WORKERS];
+    int numWorkers_ = 0;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> busy_{false};
+    std::atomic<bool> quit_{false};
+    std::atomic<uint32_t> wakeSeq_{0};
+
+    /* Current job batch, see packClaim */
+    std::atomic<uint64_t> claim_{0};
+    std::atomic<int> done_{0};
+    uint32_t generation_ = 0;
+    JobFn fn_ = nullptr;
+    void *ctx_ = nullptr;
+
+    /* The thread calling run(), whose scheduling the workers copy */
+    std::atomic<pthread_t> runThread_{pthread_t()};
+    std::atomic<uint32_t> runThreadSeq_{0};     /* Bumped when it changes */
+};
+
+#endif /* RENDER_POOL_H */
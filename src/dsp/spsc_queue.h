@@ -0,0 +1,74 @@
+/*
+ * spsc_queue.h - Bounded single-producer/single-consumer queue
+ *
+ * One thread pushes, one thread pops; neither locks, allocates or waits.
+ * The producer owns tail_ and the consumer owns head_, each on its own
+ * cache line, and each side publishes its index with a release store that
+ * the other side reads with an acquire load.
+ *
+ * A push onto a full queue fails and is counted in overflows(), which any
+ * thread may read. The consumer can look at the next item with peek()
+ * before deciding to pop it. Capacity must be a power of two.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+template <class T, int Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue() {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /* Producer: false if the queue is full */
+    bool push(const T &item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= (uint32_t)Capacity) {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer: false if the queue is empty */
+    bool pop(T &item) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        item = items_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer: the item pop() would return, or NULL if the queue is empty */
+    const T *peek() const {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return NULL;
+        return &items_[head & (Capacity - 1)];
+    }
+
+    uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> head_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> overflows_{0};
+    alignas(CACHE_LINE_SIZE) T items_[Capacity];
+};
+
+#endif /* SPSC_QUEUE_H */
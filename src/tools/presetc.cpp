@@ -0,0 +1,67 @@
+/*
+ * presetc - compile Hera XML presets into a binary bank
+ *
+ * Usage: presetc -o presets.bin Preset000.xml Preset001.xml ...
+ *
+ * Presets are stored in argument order, parsed exactly as the plugin's
+ * XML fallback parses them. Runs on the build host; the bank format is
+ * described in hera_presets.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "hera_presets.h"
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+    std::vector<const char*> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else
+            inputs.push_back(argv[i]);
+    }
+    if (!out_path) {
+        fprintf(stderr, "usage: %s -o presets.bin Preset000.xml ...\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<HeraPreset> presets;
+    for (const char *path : inputs) {
+        bool exists;
+        char *data = read_preset_file(path, &exists);
+        if (!data) {
+            fprintf(stderr, "presetc: cannot read %s\n", path);
+            return 1;
+        }
+        HeraPreset p;
+        parse_preset_xml(data, &p, (int)presets.size());
+        presets.push_back(p);
+        free(data);
+    }
+
+    HeraBankHeader header;
+    hera_bank_header_init(&header, (uint32_t)presets.size());
+
+    FILE *f = fopen(out_path, "wb");
+    if (!f) {
+        fprintf(stderr, "presetc: cannot write %s\n", out_path);
+        return 1;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if (!presets.empty())
+        ok = ok && fwrite(presets.data(), sizeof(HeraPreset), presets.size(), f) == presets.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        fprintf(stderr, "presetc: error writing %s\n", out_path);
+        remove(out_path);
+        return 1;
+    }
+
+    printf("presetc: %d presets -> %s\n", (int)presets.size(), out_path);
+    return 0;
+}
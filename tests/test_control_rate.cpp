@@ -0,0 +1,137 @@
+/*
+ * test_control_rate - control_interval against audio-rate modulation
+ *
+ * Renders the same patch and notes in two instances, one with
+ * control_interval 1 and one with a coarser interval, and compares the
+ * pitch-LFO detune and every sounding voice's filter cutoff sample by
+ * sample. The patch drives both as hard as the parameters allow: fastest
+ * LFO at full pitch and filter depth, full filter envelope with the
+ * fastest attack, key tracking and pitch bend sweeps.
+ *
+ * Tolerances are the largest difference in pitch over any sample, in
+ * two windows. For the two blocks (256 samples) after a note-on, the LFO
+ * fade-in and the filter envelope attack rise too steeply for the
+ * interpolation to follow. Everything after that counts as settled.
+ *
+ *   interval   settled detune  settled cutoff  note-on detune  note-on cutoff
+ *   8          0.2 cent        0.002 octave    12 cents        0.3 octave
+ *   16         0.4 cent        0.004 octave    35 cents        0.3 octave
+ *   32         1 cent          0.01 octave     80 cents        0.3 octave
+ *
+ * Includes the plugin source to read its render buffers. Runs on the
+ * build host.
+ */
+
+#include "hera_plugin.cpp"
+
+struct Tolerance {
+    int interval;
+    float settledDetuneCents;
+    float settledCutoffOctaves;
+    float onsetDetuneCents;
+    float onsetCutoffOctaves;
+};
+
+static const Tolerance kTolerances[] = {
+    { 8, 0.2f, 0.002f, 12.0f, 0.3f },
+    { 16, 0.4f, 0.004f, 35.0f, 0.3f },
+    { 32, 1.0f, 0.01f, 80.0f, 0.3f },
+};
+
+static const int kBlocks = 3000;
+static const int kFrames = 128;
+static const int kNotePeriod = 40;      /* Blocks from one chord to the next */
+static const int kOnsetBlocks = 2;
+
+static void set_patch(plugin_api_v2_t *api, void *inst, int interval) {
+    char value[16];
+    snprintf(value, sizeof(value), "%d", interval);
+    api->set_param(inst, "control_interval", value);
+    api->set_param(inst, "cpu_limit", "0");
+    api->set_param(inst, "silence_floor", "-120");
+    api->set_param(inst, "params",
+                   "{\"lfo_rate\":1,\"lfo_delay\":0,\"pitch_mod\":1,"
+                   "\"vcf_cutoff\":0.3,\"vcf_resonance\":0.5,\"vcf_env\":1,"
+                   "\"vcf_lfo\":1,\"vcf_key\":1,\"vcf_bend\":1,"
+                   "\"attack\":0,\"decay\":0.2,\"sustain\":0.4,\"release\":0.2}");
+}
+
+static void send_midi(plugin_api_v2_t *api, void *a, void *b, uint8_t s, uint8_t d1, uint8_t d2) {
+    uint8_t msg[3] = { s, d1, d2 };
+    api->on_midi(a, msg, 3, 0);
+    api->on_midi(b, msg, 3, 0);
+}
+
+/* Largest |log2(x / y)| over the first count samples */
+static float max_octaves_apart(const float *x, const float *y, int count) {
+    float worst = 0.0f;
+    for (int i = 0; i < count; i++)
+        worst = std::max(worst, fabsf(log2f(x[i] / y[i])));
+    return worst;
+}
+
+static bool run(plugin_api_v2_t *api, const Tolerance &tol) {
+    hera_instance_t *ref = (hera_instance_t *)api->create_instance(".", "{}");
+    hera_instance_t *test = (hera_instance_t *)api->create_instance(".", "{}");
+    set_patch(api, ref, 1);
+    set_patch(api, test, tol.interval);
+
+    int16_t out[kFrames * 2];
+    float worstDetune[2] = {}, worstCutoff[2] = {};  /* settled, note-on */
+
+    for (int b = 0; b < kBlocks; b++) {
+        int root = 36 + (b / kNotePeriod) % 36;
+        if (b % kNotePeriod == 0)
+            for (int n = 0; n < 3; n++)
+                send_midi(api, ref, test, 0x90, (uint8_t)(root + 7 * n), 110);
+        if (b % kNotePeriod == 25)
+            for (int n = 0; n < 3; n++)
+                send_midi(api, ref, test, 0x80, (uint8_t)(root + 7 * n), 0);
+        if (b % 4 == 0)
+            send_midi(api, ref, test, 0xE0, 0, (uint8_t)(64 + 63 * sinf(b * 0.05f)));
+
+        bool sounding[MAX_VOICES];
+        for (int v = 0; v < MAX_VOICES; v++)
+            sounding[v] = ref->voices[v].active && test->voices[v].active;
+
+        api->render_block(ref, out, kFrames);
+        api->render_block(test, out, kFrames);
+
+        int window = (b % kNotePeriod < kOnsetBlocks) ? 1 : 0;
+        worstDetune[window] = std::max(worstDetune[window],
+                                       max_octaves_apart(ref->detuneBuffer, test->detuneBuffer,
+                                                         kFrames));
+        for (int v = 0; v < MAX_VOICES; v++) {
+            if (sounding[v])
+                worstCutoff[window] = std::max(worstCutoff[window],
+                                               max_octaves_apart(ref->cutoffBuffer[v],
+                                                                 test->cutoffBuffer[v], kFrames));
+        }
+    }
+
+    api->destroy_instance(ref);
+    api->destroy_instance(test);
+
+    bool ok = worstDetune[0] * 1200.0f <= tol.settledDetuneCents &&
+              worstCutoff[0] <= tol.settledCutoffOctaves &&
+              worstDetune[1] * 1200.0f <= tol.onsetDetuneCents &&
+              worstCutoff[1] <= tol.onsetCutoffOctaves;
+    printf("test_control_rate: interval %d: settled detune %.3f cents, cutoff %.4f octaves; "
+           "note-on detune %.2f cents, cutoff %.3f octaves%s\n",
+           tol.interval, worstDetune[0] * 1200.0f, worstCutoff[0],
+           worstDetune[1] * 1200.0f, worstCutoff[1], ok ? "" : " FAILED");
+    return ok;
+}
+
+int main() {
+    static host_api_v1_t host;
+    host.api_version = MOVE_PLUGIN_API_VERSION;
+    host.sample_rate = MOVE_SAMPLE_RATE;
+    host.frames_per_block = kFrames;
+    plugin_api_v2_t *api = move_plugin_init_v2(&host);
+
+    int failures = 0;
+    for (const Tolerance &tol : kTolerances)
+        failures += !run(api, tol);
+    return failures ? 1 : 0;
+}
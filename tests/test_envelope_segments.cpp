@@ -0,0 +1,297 @@
+/*
+ * test_envelope_segments - branch-free segment runs against the end test
+ *
+ * AbstractEnvelope::processNextBlock computes attack, decay and shutdown
+ * samples in runs with no end test, as long as
+ * EnvelopeShape::samplesBeforeEnd allows. This checks that against a
+ * reference that tests for the segment's end at every sample, as the
+ * envelope did before the runs:
+ *
+ *  - samplesBeforeEnd never returns a run that contains the segment's end,
+ *    for values along each segment's own trajectory and on a grid;
+ *  - whole envelopes, driven by note on/off and shutdown at random sample
+ *    positions in blocks of random size, produce bit-identical output and
+ *    the same phase after every block. The ADSR sweep includes the
+ *    shortest segments (slider 0), a sustain below, at and just above the
+ *    0.02 floor, and full sustain. The LFO shape includes a zero delay,
+ *    and one shape has every segment at zero length.
+ *
+ * Runs on the build host.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <array>
+#include <algorithm>
+#include <vector>
+
+#include "HeraEnvelope.h"
+#include "HeraTables.h"
+
+static int failures = 0;
+
+static void fail(const char *what, const char *shape, long at) {
+    if (failures++ < 10)
+        fprintf(stderr, "test_envelope_segments: %s: %s at sample %ld\n", shape, what, at);
+}
+
+/* One sample of an attack, decay or shutdown segment, with the end test.
+   False if the segment ends instead. */
+static bool step_segment(const EnvelopeShape &shape, int segmentIndex, float *value) {
+    const EnvelopeSegment &segment = shape.getSegment(segmentIndex);
+    const EnvelopeShape::SegmentData &data = shape.getData(segmentIndex);
+    switch (segment.type) {
+    case EnvelopeSegment::Attack: {
+        float next = *value * data.u.ad.coeff + data.u.ad.offset;
+        if (next > segment.target && !segment.sustained)
+            return false;
+        *value = std::min(segment.target, next);
+        return true;
+    }
+    case EnvelopeSegment::Decay: {
+        float next = *value * data.u.ad.coeff + data.u.ad.offset;
+        if ((next <= segment.target && !segment.sustained) || next < 0.02f)
+            return false;
+        *value = std::max(segment.target, next);
+        return true;
+    }
+    default: {
+        float next = *value - data.u.shutdown.rate;
+        if (next <= 0.0f)
+            return false;
+        *value = std::max(0.0f, next);
+        return true;
+    }
+    }
+}
+
+/* The envelope as it was before samplesBeforeEnd: the end test at every sample */
+class ReferenceEnvelope {
+public:
+    explicit ReferenceEnvelope(const EnvelopeShape *shape) : shape_(shape) {}
+
+    void noteOn() {
+        phase_ = 0;
+        enter(0);
+    }
+    void noteOff() {
+        if (phase_ != -1)
+            phase_ = std::max(phase_, shape_->getNumSegments() - 2);
+    }
+    void shutdown() {
+        if (phase_ != -1)
+            phase_ = std::max(phase_, shape_->getNumSegments() - 1);
+    }
+    int phase() const { return phase_; }
+
+    void process(float *output, int numSamples) {
+        for (int i = 0; i < numSamples; i++) {
+            while (phase_ != -1 && !step())
+                advance();
+            output[i] = (phase_ == -1) ? 0.0f : value_;
+            if (phase_ == -1)
+                value_ = 0.0f;
+        }
+    }
+
+private:
+    void enter(int segmentIndex) {
+        if (shape_->getSegment(segmentIndex).type == EnvelopeSegment::Delay)
+            delayRemaining_ = shape_->getData(segmentIndex).duration;
+    }
+
+    void advance() {
+        phase_ = (phase_ + 1 < shape_->getNumSegments()) ? phase_ + 1 : -1;
+        if (phase_ != -1)
+            enter(phase_);
+    }
+
+    /* One sample of the current segment; false if the segment ends instead */
+    bool step() {
+        if (shape_->getSegment(phase_).type != EnvelopeSegment::Delay)
+            return step_segment(*shape_, phase_, &value_);
+        delayRemaining_ -= 1.0f / shape_->getSampleRate();
+        if (delayRemaining_ < 0.0f)
+            return false;
+        value_ = 0.0f;
+        return true;
+    }
+
+    const EnvelopeShape *shape_;
+    int phase_ = -1;
+    float value_ = 0.0f;
+    float delayRemaining_ = 0.0f;
+};
+
+/* Does segmentIndex, started from value, reach its end within run samples? */
+static bool ends_within(const EnvelopeShape &shape, int segmentIndex, float value, int run) {
+    for (int i = 0; i < run; i++) {
+        if (!step_segment(shape, segmentIndex, &value))
+            return true;
+    }
+    return false;
+}
+
+static void check_runs_from(const EnvelopeShape &shape, int segmentIndex, float value,
+                            const char *name) {
+    static const int kMaxRuns[] = { 1, 8, 64, 512 };
+    for (int maxRun : kMaxRuns) {
+        int run = shape.samplesBeforeEnd(segmentIndex, value, maxRun);
+        if (run < 0 || run > maxRun)
+            fail("run outside [0, maxRun]", name, segmentIndex);
+        else if (ends_within(shape, segmentIndex, value, run))
+            fail("run contains the segment end", name, segmentIndex);
+    }
+}
+
+static void check_samples_before_end(const EnvelopeShape &shape, const char *name) {
+    static const int kMaxRuns[] = { 1, 8, 64, 512 };
+    static std::vector<float> trajectory;
+
+    for (int s = 0; s < shape.getNumSegments(); s++) {
+        if (shape.getSegment(s).type == EnvelopeSegment::Delay)
+            continue;
+
+        /* A grid of starting values, including past the target */
+        for (int i = 0; i <= 240; i++)
+            check_runs_from(shape, s, (float)i / 200.0f, name);
+
+        /* The segment's own trajectory from either end. Where it ends at
+           step `end`, a run from step k must not pass end - k; where it
+           holds at a sustained target, the end never comes. */
+        const float starts[] = { 0.0f, 1.0f };
+        for (float value : starts) {
+            trajectory.clear();
+            long end = -1;
+            bool held = false;
+            while (trajectory.size() < (1u << 22)) {
+                trajectory.push_back(value);
+                float next = value;
+                if (!step_segment(shape, s, &next)) {
+                    end = (long)trajectory.size() - 1;
+                    break;
+                }
+                if (next == value) {
+                    held = true;
+                    break;
+                }
+                value = next;
+            }
+            if (end < 0 && !held) {
+                fail("segment neither ends nor holds", name, s);
+                continue;
+            }
+
+            for (size_t k = 0; k < trajectory.size(); k++) {
+                for (int maxRun : kMaxRuns) {
+                    int run = shape.samplesBeforeEnd(s, trajectory[k], maxRun);
+                    if (run < 0 || run > maxRun)
+                        fail("run outside [0, maxRun]", name, (long)k);
+                    else if (end >= 0 && run > end - (long)k)
+                        fail("run contains the segment end", name, (long)k);
+                }
+            }
+        }
+    }
+}
+
+static void compare_envelopes(const EnvelopeShape &shape, const char *name, unsigned seed) {
+    srand(seed);
+    AbstractEnvelope envelope(&shape);
+    ReferenceEnvelope reference(&shape);
+    float out[512], want[512];
+    long at = 0;
+    int untilEvent = 0;
+
+    for (int block = 0; block < 400; block++) {
+        int remaining = 1 + rand() % 512;
+        while (remaining > 0) {
+            if (untilEvent == 0) {
+                int event = rand() % 8;
+                if (event < 4) {
+                    envelope.noteOn();
+                    reference.noteOn();
+                }
+                else if (event < 7) {
+                    envelope.noteOff();
+                    reference.noteOff();
+                }
+                else {
+                    envelope.shutdown();
+                    reference.shutdown();
+                }
+                untilEvent = (rand() % 4 == 0) ? rand() % 16 : rand() % 20000;
+            }
+
+            int count = std::min(remaining, std::max(1, untilEvent));
+            envelope.processNextBlock(out, 0, count);
+            reference.process(want, count);
+            if (memcmp(out, want, count * sizeof(float)) != 0)
+                fail("output differs", name, at);
+            if (envelope.isActive() != (reference.phase() != -1) ||
+                envelope.isReleased() != (reference.phase() == -1 ||
+                                          reference.phase() >= shape.getNumSegments() - 2))
+                fail("phase differs", name, at);
+
+            at += count;
+            remaining -= count;
+            untilEvent -= std::min(untilEvent, count);
+        }
+    }
+}
+
+static const std::array<EnvelopeSegment, 4> kLFOSegments {{
+    {EnvelopeSegment::Delay},
+    {EnvelopeSegment::Attack, 0.03f, 1.0f, true},
+    {EnvelopeSegment::Decay, 0.025f, 0.0f, false},
+    {EnvelopeSegment::Shutdown, 0.001f},
+}};
+
+int main() {
+    static const float kSliders[] = { 0.0f, 0.05f, 0.3f, 1.0f };
+    static const float kSustains[] = { 0.0f, 0.01f, 0.02f, 0.0201f, 0.5f, 1.0f };
+    char name[96];
+    unsigned seed = 1;
+
+    for (float attack : kSliders)
+        for (float decay : kSliders)
+            for (float sustain : kSustains)
+                for (float release : kSliders) {
+                    HeraEnvelopeShape adsr;
+                    adsr.setAttack(attack);
+                    adsr.setDecay(decay);
+                    adsr.setSustain(sustain);
+                    adsr.setRelease(release);
+                    snprintf(name, sizeof(name), "ADSR %g/%g/%g/%g", attack, decay, sustain, release);
+                    check_samples_before_end(*adsr.getShape(), name);
+                    compare_envelopes(*adsr.getShape(), name, seed++);
+                }
+
+    static const float kDelays[] = { 0.0f, 0.001f, 0.5f };
+    for (float delay : kDelays)
+        for (float lfoAttack : kSliders) {
+            EnvelopeShape lfo(kLFOSegments);
+            lfo.setDuration(0, delay);
+            lfo.setDuration(1, curveFromLfoDelaySliderToAttack(lfoAttack));
+            lfo.setDuration(2, 0.1f);
+            snprintf(name, sizeof(name), "LFO delay %g attack %g", delay, lfoAttack);
+            check_samples_before_end(lfo, name);
+            compare_envelopes(lfo, name, seed++);
+        }
+
+    /* Every segment zero-length, down to the duration clamps */
+    EnvelopeShape zero(kLFOSegments);
+    for (int i = 0; i < zero.getNumSegments() - 1; i++)
+        zero.setDuration(i, 0.0f);
+    check_samples_before_end(zero, "all zero-length");
+    compare_envelopes(zero, "all zero-length", seed++);
+
+    if (failures) {
+        fprintf(stderr, "test_envelope_segments: %d failures\n", failures);
+        return 1;
+    }
+    printf("test_envelope_segments: %u shapes match the per-sample end test\n", seed - 1);
+    return 0;
+}
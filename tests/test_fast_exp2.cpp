@@ -0,0 +1,92 @@
+/*
+ * test_fast_exp2 - check fastExp2 against libm's exp2f
+ *
+ * Sweeps x over the clamped range [-126, 127], densely, and asserts the
+ * bound documented in FastExp2.h: relative error below 3e-7. The vector
+ * and buffer forms must agree with the scalar one bit for bit, and inputs
+ * outside the range must clamp to its ends. Runs on the build host.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "FastExp2.h"
+
+static const double kMaxRelError = 3e-7;
+
+static int failures = 0;
+
+static void expect(bool ok, const char *what, float x, float got, float want) {
+    if (!ok && failures++ < 10)
+        fprintf(stderr, "test_fast_exp2: %s at x=%.9g: got %.9g, want %.9g\n", what, x, got, want);
+}
+
+static float ith_simd_lane(SimdFloat v, int lane) {
+    float lanes[kSimdLanes];
+    memcpy(lanes, &v, sizeof(lanes));
+    return lanes[lane];
+}
+
+static double worst = 0.0;
+static float worstX = 0.0f;
+
+static void check_against_libm(float x) {
+    float got = fastExp2(x);
+    float want = exp2f(x);
+    double err = fabs((double)got - (double)want) / (double)want;
+    if (err > worst) {
+        worst = err;
+        worstX = x;
+    }
+    expect(err < kMaxRelError, "relative error", x, got, want);
+}
+
+int main() {
+    const int kSteps = 1 << 22;
+    const float lo = FastExp2Detail::kMin, hi = FastExp2Detail::kMax;
+
+    for (int i = 0; i <= kSteps; i++)
+        check_against_libm(lo + (hi - lo) * (float)i / (float)kSteps);
+
+    /* Every float in [1, 2) and [-2, -1): between them they hand the
+       polynomial every fraction on the 2^-23 grid */
+    for (float x = 1.0f; x < 2.0f; x = nextafterf(x, 2.0f))
+        check_against_libm(x);
+    for (float x = -2.0f; x < -1.0f; x = nextafterf(x, -1.0f))
+        check_against_libm(x);
+
+    /* Vector and buffer forms, including a scalar tail */
+    float in[kSimdLanes * 64 + 3], out[kSimdLanes * 64 + 3];
+    const int count = (int)(sizeof(in) / sizeof(in[0]));
+    for (int i = 0; i < count; i++)
+        in[i] = -130.0f + 260.0f * (float)i / (float)(count - 1);
+    fastExp2Buffer(in, out, 0.5f, count);
+    for (int i = 0; i < count; i++) {
+        float want = 0.5f * fastExp2(in[i]);
+        expect(out[i] == want, "buffer/scalar mismatch", in[i], out[i], want);
+    }
+    for (int i = 0; i + kSimdLanes <= count; i += kSimdLanes) {
+        SimdFloat x;
+        memcpy(&x, in + i, sizeof(x));
+        SimdFloat y = fastExp2(x);
+        for (int lane = 0; lane < kSimdLanes; lane++) {
+            float got = ith_simd_lane(y, lane);
+            float want = fastExp2(in[i + lane]);
+            expect(got == want, "vector/scalar mismatch", in[i + lane], got, want);
+        }
+    }
+
+    /* Clamping */
+    expect(fastExp2(-1000.0f) == fastExp2(lo), "clamp below", -1000.0f, fastExp2(-1000.0f), fastExp2(lo));
+    expect(fastExp2(1000.0f) == fastExp2(hi), "clamp above", 1000.0f, fastExp2(1000.0f), fastExp2(hi));
+
+    printf("test_fast_exp2: worst relative error %.3g at x=%.9g (bound %.3g)\n",
+           worst, worstX, kMaxRelError);
+    if (failures) {
+        fprintf(stderr, "test_fast_exp2: %d failures\n", failures);
+        return 1;
+    }
+    return 0;
+}